@@ -0,0 +1,160 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "Animator.h"
+
+#include <cmath>
+#include <algorithm>
+
+using std::vector;
+using std::function;
+using cocos2d::Sprite;
+using cocos2d::Animation;
+
+namespace vigilante {
+
+Animator::Animator() : _tracks(), _freeHandles() {}
+
+
+void Animator::update(float delta) {
+  // The finished callbacks are invoked after all tracks have been advanced,
+  // since they may add/remove/play tracks themselves.
+  vector<Animator::Handle> finishedTracks;
+
+  for (size_t i = 0; i < _tracks.size(); i++) {
+    Track& track = _tracks[i];
+    Animation* leadingAnimation = track.animations[0];
+    if (!track.isActive || track.isFinished || !leadingAnimation) {
+      continue;
+    }
+
+    int frameCount = leadingAnimation->getFrames().size();
+    float interval = leadingAnimation->getDelayPerUnit();
+    if (frameCount == 0) {
+      continue;
+    }
+
+    track.elapsed += delta;
+    int frameIdx = (interval > 0) ? static_cast<int>(track.elapsed / interval) : frameCount;
+
+    if (frameIdx >= frameCount) {
+      if (track.loop) {
+        track.elapsed = (interval > 0) ? std::fmod(track.elapsed, interval * frameCount) : 0;
+        frameIdx %= frameCount;
+      } else {
+        frameIdx = frameCount - 1;
+        track.isFinished = true;
+        if (track.onFinished) {
+          finishedTracks.push_back(i);
+        }
+      }
+    }
+
+    if (frameIdx != track.frameIdx) {
+      track.frameIdx = frameIdx;
+      showFrame(track);
+    }
+  }
+
+  for (auto handle : finishedTracks) {
+    Track& track = _tracks[handle];
+    // An earlier callback may have replayed this track (play() resets isFinished),
+    // in which case onFinished belongs to the new animation.
+    if (!track.isActive || !track.isFinished || !track.onFinished) {
+      continue;
+    }
+    function<void ()> onFinished;
+    onFinished.swap(track.onFinished);
+    onFinished();
+  }
+}
+
+
+Animator::Handle Animator::add() {
+  Animator::Handle handle;
+
+  if (!_freeHandles.empty()) {
+    handle = _freeHandles.back();
+    _freeHandles.pop_back();
+    _tracks[handle] = Track();
+  } else {
+    handle = _tracks.size();
+    _tracks.push_back(Track());
+  }
+
+  _tracks[handle].isActive = true;
+  return handle;
+}
+
+void Animator::remove(Animator::Handle handle) {
+  if (handle < 0 || handle >= (int) _tracks.size() || !_tracks[handle].isActive) {
+    return;
+  }
+  _tracks[handle] = Track();
+  _freeHandles.push_back(handle);
+}
+
+void Animator::setLayer(Animator::Handle handle, int layer, Sprite* sprite) {
+  if (handle < 0 || handle >= (int) _tracks.size() || layer < 0 || layer >= _kMaxLayers) {
+    return;
+  }
+
+  Track& track = _tracks[handle];
+  track.sprites[layer] = sprite;
+  if (!sprite) {
+    track.animations[layer] = nullptr;
+  }
+}
+
+void Animator::play(Animator::Handle handle, const Animator::Layers& animations,
+                    bool loop, const function<void ()>& onFinished) {
+  if (handle < 0 || handle >= (int) _tracks.size()) {
+    return;
+  }
+
+  Track& track = _tracks[handle];
+  track.animations = animations;
+  track.loop = loop;
+  track.isFinished = false;
+  track.frameIdx = 0;
+  track.elapsed = 0;
+  track.onFinished = onFinished;
+  showFrame(track);
+}
+
+
+void Animator::showFrame(Animator::Track& track) {
+  for (int layer = 0; layer < _kMaxLayers; layer++) {
+    showFrame(track, layer);
+  }
+}
+
+void Animator::showFrame(Animator::Track& track, int layer) {
+  Sprite* sprite = track.sprites[layer];
+  Animation* animation = track.animations[layer];
+  if (!sprite || !animation) {
+    return;
+  }
+
+  const auto& frames = animation->getFrames();
+  if (frames.empty()) {
+    return;
+  }
+
+  // A layer may have fewer frames than the leading layer (e.g., when
+  // the fallback animation is used), so wrap around or hold its last frame.
+  int frameCount = frames.size();
+  int frameIdx = (track.loop) ? track.frameIdx % frameCount : std::min(track.frameIdx, frameCount - 1);
+  sprite->setSpriteFrame(frames.at(frameIdx)->getSpriteFrame());
+}
+
+
+Animator::Track::Track()
+    : isActive(),
+      loop(),
+      isFinished(),
+      frameIdx(),
+      elapsed(),
+      sprites(),
+      animations(),
+      onFinished() {}
+
+} // namespace vigilante
@@ -0,0 +1,75 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_ANIMATOR_H_
+#define VIGILANTE_ANIMATOR_H_
+
+#include <array>
+#include <vector>
+#include <functional>
+
+#include <cocos2d.h>
+
+namespace vigilante {
+
+// Animator drives all sprite animations of the actors on the map.
+//
+// Instead of allocating cocos2d::Animate / Repeat actions and running them
+// on each sprite whenever an actor changes its state, each actor owns a track
+// in Animator. A track consists of several layers (e.g., body + equipment)
+// which share the same clock, so they always stay frame-locked.
+//
+// All tracks are kept in a contiguous array and advanced in Animator::update().
+// Switching to another animation only overwrites the animation pointers
+// of a track, and the sprites are only touched when their frame changes.
+class Animator {
+ public:
+  using Handle = int;
+
+  static const int _kMaxLayers = 8;
+  static const Handle _kInvalidHandle = -1;
+  using Layers = std::array<cocos2d::Animation*, Animator::_kMaxLayers>;
+
+  Animator();
+  virtual ~Animator() = default;
+
+  void update(float delta);
+
+  // Allocate / release a track. Released tracks are recycled by add().
+  Animator::Handle add();
+  void remove(Animator::Handle handle);
+
+  // Attach a sprite to the specified layer of a track.
+  // Pass nullptr to detach the sprite (and its animation) from that layer.
+  void setLayer(Animator::Handle handle, int layer, cocos2d::Sprite* sprite);
+
+  // Play the specified animations on the layers of a track from the first frame.
+  // Layer 0 is the leading layer which determines the length of the animation.
+  // If loop is false, onFinished (if any) will be called when layer 0 reaches its end.
+  void play(Animator::Handle handle, const Animator::Layers& animations,
+            bool loop=true, const std::function<void ()>& onFinished=nullptr);
+
+ private:
+  struct Track {
+    Track();
+
+    bool isActive;
+    bool loop;
+    bool isFinished;
+    int frameIdx;
+    float elapsed;
+
+    std::array<cocos2d::Sprite*, Animator::_kMaxLayers> sprites;
+    Animator::Layers animations;
+    std::function<void ()> onFinished;
+  };
+
+  // Set the sprite frame of each layer according to track.frameIdx.
+  static void showFrame(Animator::Track& track);
+  static void showFrame(Animator::Track& track, int layer);
+
+  std::vector<Animator::Track> _tracks;
+  std::vector<Animator::Handle> _freeHandles;
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_ANIMATOR_H_
@@ -5,8 +5,11 @@
 
 #include "AssetManager.h"
 #include "Constants.h"
+#include "gameplay/AutoSave.h"
+#include "input/InputRecorder.h"
 #include "scene/MainMenuScene.h"
 #include "scene/MainGameScene.h"
+#include "util/Logger.h"
 
 #define USE_AUDIO_ENGINE 1
 // #define USE_SIMPLE_AUDIO_ENGINE 1
@@ -35,6 +38,13 @@ static cocos2d::Size mediumResolutionSize = cocos2d::Size(1024, 768);
 static cocos2d::Size largeResolutionSize = cocos2d::Size(2048, 1536);
 
 AppDelegate::~AppDelegate() {
+  // Write the recorded session (if any) to disk.
+  vigilante::InputRecorder::getInstance()->endSession();
+  // Wait for the pending autosave (if any) to hit the disk.
+  vigilante::AutoSave::getInstance()->flush();
+  // Write out the queued log messages.
+  vigilante::logger::flush();
+
 #if USE_AUDIO_ENGINE
   AudioEngine::end();
 #elif USE_SIMPLE_AUDIO_ENGINE
@@ -79,7 +89,13 @@ bool AppDelegate::applicationDidFinishLaunching() {
   vigilante::asset_manager::loadSpritesheets(vigilante::asset_manager::kSpritesheetsList);
 
   // Create a scene (auto-release object).
-  Scene* scene = vigilante::MainMenuScene::create();
+  // A replay starts right in the game, skipping the main menu.
+  Scene* scene = nullptr;
+  if (vigilante::InputRecorder::getInstance()->isReplaying()) {
+    scene = vigilante::MainGameScene::create();
+  } else {
+    scene = vigilante::MainMenuScene::create();
+  }
   director->runWithScene(scene);
 
   return true;
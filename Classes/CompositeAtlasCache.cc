@@ -0,0 +1,128 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "CompositeAtlasCache.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "util/Logger.h"
+
+using std::string;
+using std::vector;
+using cocos2d::Configuration;
+using cocos2d::Texture2D;
+using cocos2d::RenderTexture;
+using cocos2d::Animation;
+using cocos2d::Sprite;
+using cocos2d::SpriteFrame;
+using cocos2d::Size;
+using cocos2d::Rect;
+
+namespace vigilante {
+
+CompositeAtlasCache::CompositeAtlasCache() : _atlases() {}
+
+CompositeAtlasCache::~CompositeAtlasCache() {
+  clear();
+}
+
+
+const vector<Animation*>* CompositeAtlasCache::bake(const string& signature,
+                                                    const vector<CompositeAtlasCache::Clip>& clips) {
+  auto it = _atlases.find(signature);
+  if (it != _atlases.end()) {
+    return &(it->second.animations);
+  }
+
+  // Every composite frame occupies a cell which is large enough
+  // to hold the largest frame among all layers.
+  Size cellSize;
+  int frameCount = 0;
+  for (const auto& clip : clips) {
+    if (clip.empty() || !clip[0]) {
+      return nullptr;
+    }
+    for (auto animation : clip) {
+      if (!animation) {
+        continue;
+      }
+      for (auto animationFrame : animation->getFrames()) {
+        const Size& size = animationFrame->getSpriteFrame()->getOriginalSize();
+        cellSize.width = std::max(cellSize.width, size.width);
+        cellSize.height = std::max(cellSize.height, size.height);
+      }
+    }
+    frameCount += clip[0]->getFrames().size();
+  }
+
+  if (frameCount == 0 || cellSize.width <= 0 || cellSize.height <= 0) {
+    return nullptr;
+  }
+
+  int cols = static_cast<int>(std::ceil(std::sqrt(frameCount)));
+  int rows = (frameCount + cols - 1) / cols;
+  int atlasWidth = static_cast<int>(std::ceil(cols * cellSize.width));
+  int atlasHeight = static_cast<int>(std::ceil(rows * cellSize.height));
+
+  int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+  if (atlasWidth > maxTextureSize || atlasHeight > maxTextureSize) {
+    VGLOG(LOG_WARN, "Unable to bake composite atlas [%s]: %dx%d", signature.c_str(), atlasWidth, atlasHeight);
+    return nullptr;
+  }
+
+  Atlas atlas;
+  atlas.renderTexture = RenderTexture::create(atlasWidth, atlasHeight, Texture2D::PixelFormat::RGBA8888);
+  atlas.renderTexture->retain();
+  Texture2D* texture = atlas.renderTexture->getSprite()->getTexture();
+  texture->setAliasTexParameters();
+
+  // The content of a RenderTexture is upside down (OpenGL's origin is bottom-left),
+  // so each layer is drawn flipped vertically, and then a SpriteFrame's rect
+  // (whose origin is top-left) lands right on its cell.
+  atlas.renderTexture->beginWithClear(0, 0, 0, 0);
+  int cellIdx = 0;
+
+  for (const auto& clip : clips) {
+    int clipFrameCount = clip[0]->getFrames().size();
+    cocos2d::Vector<SpriteFrame*> frames;
+
+    for (int i = 0; i < clipFrameCount; i++, cellIdx++) {
+      Rect cellRect((cellIdx % cols) * cellSize.width, (cellIdx / cols) * cellSize.height,
+                    cellSize.width, cellSize.height);
+
+      for (auto animation : clip) {
+        if (!animation || animation->getFrames().empty()) {
+          continue;
+        }
+        // Layers with fewer frames than the leading layer wrap around (same as Animator).
+        const auto& layerFrames = animation->getFrames();
+        Sprite* sprite = Sprite::createWithSpriteFrame(layerFrames.at(i % layerFrames.size())->getSpriteFrame());
+        sprite->setFlippedY(true);
+        sprite->setPosition(cellRect.getMidX(), cellRect.getMidY());
+        sprite->visit();
+      }
+
+      frames.pushBack(SpriteFrame::createWithTexture(texture, cellRect));
+    }
+
+    Animation* animation = Animation::createWithSpriteFrames(frames, clip[0]->getDelayPerUnit());
+    animation->retain();
+    atlas.animations.push_back(animation);
+  }
+
+  atlas.renderTexture->end();
+
+  VGLOG(LOG_INFO, "Baked composite atlas [%s]: %d frames, %dx%d", signature.c_str(), frameCount, atlasWidth, atlasHeight);
+  return &(_atlases.insert({signature, atlas}).first->second.animations);
+}
+
+void CompositeAtlasCache::clear() {
+  for (auto& atlas : _atlases) {
+    for (auto animation : atlas.second.animations) {
+      animation->release();
+    }
+    atlas.second.renderTexture->release();
+  }
+  _atlases.clear();
+}
+
+} // namespace vigilante
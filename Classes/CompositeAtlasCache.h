@@ -0,0 +1,47 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_COMPOSITE_ATLAS_CACHE_H_
+#define VIGILANTE_COMPOSITE_ATLAS_CACHE_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <cocos2d.h>
+
+namespace vigilante {
+
+// CompositeAtlasCache bakes several layers of frame-locked animations
+// (e.g., a character's body + equipment) into a single runtime atlas,
+// so that they can be drawn as one sprite with one animation.
+//
+// Atlases are cached by their signature (e.g., body + equipment textureResDirs),
+// so characters wearing the same set of equipment share the same atlas.
+// The cache is cleared whenever another GameMap is loaded.
+class CompositeAtlasCache {
+ public:
+  // The layers of a clip, from bottom to top.
+  // Layer 0 is the leading layer which determines the length and interval of the clip.
+  using Clip = std::vector<cocos2d::Animation*>;
+
+  CompositeAtlasCache();
+  virtual ~CompositeAtlasCache();
+
+  // Returns the composite animations (one for each clip, in the same order),
+  // baking them first if the signature hasn't been seen before.
+  // Returns nullptr if these clips cannot fit into a single texture.
+  const std::vector<cocos2d::Animation*>* bake(const std::string& signature,
+                                               const std::vector<CompositeAtlasCache::Clip>& clips);
+  void clear();
+
+ private:
+  struct Atlas {
+    cocos2d::RenderTexture* renderTexture;
+    std::vector<cocos2d::Animation*> animations;
+  };
+
+  std::unordered_map<std::string, CompositeAtlasCache::Atlas> _atlases;
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_COMPOSITE_ATLAS_CACHE_H_
@@ -23,6 +23,7 @@ void DynamicActor::removeFromMap() {
 
   _isShownOnMap = false;
   GameMapManager::getInstance()->getGameMap()->getDynamicActors().erase(this);
+  GameMapManager::getInstance()->getGameMap()->getSpatialHash().remove(this);
 
   // If _bodySpritesheet exists, we should remove it instead of _bodySprite.
   GameMapManager::getInstance()->getLayer()->removeChild(
@@ -11,6 +11,9 @@ class Interactable {
   virtual ~Interactable() = default;
   virtual void onInteract(Character* user) = 0;
   virtual bool willInteractOnContact() const = 0;
+  // Half the side length (in meters) of the square around this object
+  // which a character's feet must overlap to interact with it.
+  virtual float getInteractionRange() const = 0;
 };
 
 } // namespace vigilante
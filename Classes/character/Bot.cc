@@ -1,97 +1,275 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "Bot.h"
 
-#include <set>
+#include <algorithm>
 
+#include "Constants.h"
+#include "map/GameMapManager.h"
+#include "character/Player.h"
 #include "util/RandUtil.h"
 
-using std::set;
+using cocos2d::Director;
+using cocos2d::Size;
 
 namespace vigilante {
 
+const int Bot::_kOnScreenTickInterval = 4;
+const int Bot::_kOffScreenTickInterval = 16;
+const float Bot::_kMaxPatrolDrop = .3f;
+const float Bot::_kMinJumpClearance = .2f;
+int Bot::_botIdCounter = 0;
+
 Bot::Bot(Character* c)
     : _character(c),
+      _botId(_botIdCounter++),
+      _frameCount(),
+      _pendingDelta(),
+      _isMoving(),
+      _snapshot(),
+      _decision(),
+      _rng(rand_util::getStream(rand_util::Stream::AI).next(), _botId),
       _isMovingRight(),
       _moveDuration(),
       _moveTimer(),
       _waitDuration(),
       _waitTimer(),
+      _navPath(),
+      _navFromSpan(-1),
+      _navToSpan(-1),
+      _navEdge(-1),
+      _isOffNavSpan(),
       _lastTraveledDistance(),
       _calculateDistanceTimer() {}
 
 
-void Bot::act(float delta) {
-  if (_character->isKilled() || _character->isSetToKill() || _character->isAttacking()) {
-    return;
+void Bot::tick(float delta) {
+  _pendingDelta += delta;
+
+  int interval = getTickInterval();
+  if ((_frameCount++ + _botId) % interval == 0) {
+    GameMapManager::getInstance()->scheduleBot(this);
+  } else if (_isMoving && interval == _kOnScreenTickInterval) {
+    // Keep on moving between ticks so that an on-screen bot
+    // doesn't look slower than before.
+    if (_character->isFacingRight()) {
+      _character->moveRight();
+    } else {
+      _character->moveLeft();
+    }
+  }
+}
+
+int Bot::getTickInterval() const {
+  Player* player = GameMapManager::getInstance()->getPlayer();
+  if (!player) {
+    return _kOffScreenTickInterval;
   }
 
-  set<Character*>& inRangeTargets = _character->getInRangeTargets();
+  // The camera always follows the player, so a bot is on screen
+  // iff it is within half the visible size from the player.
+  const Size& visibleSize = Director::getInstance()->getVisibleSize();
+  b2Vec2 distance = _character->getBody()->GetPosition() - player->getBody()->GetPosition();
+  bool isOnScreen = std::abs(distance.x) <= visibleSize.width / 2 / kPpm
+    && std::abs(distance.y) <= visibleSize.height / 2 / kPpm;
+
+  if (!isOnScreen) {
+    return _kOffScreenTickInterval;
+  }
+  return (_character->isAlerted()) ? 1 : _kOnScreenTickInterval;
+}
+
+
+void Bot::captureSnapshot() {
+  perceive();
+
+  b2Body* body = _character->getBody();
+  const Character::Profile& profile = _character->getCharacterProfile();
+
+  _snapshot.delta = _pendingDelta;
+  _pendingDelta = 0;
+
+  _snapshot.isActive = !_character->isKilled() && !_character->isSetToKill() && !_character->isAttacking();
+  _snapshot.isFacingRight = _character->isFacingRight();
+  _snapshot.isJumping = _character->isJumping();
+  _snapshot.isDoubleJumping = _character->isDoubleJumping();
+  _snapshot.canDoubleJump = profile.canDoubleJump;
+  _snapshot.position = body->GetPosition();
+  _snapshot.feetPosition = getFeetPosition(_character);
+  _snapshot.headPosition = body->GetPosition();
+  _snapshot.headPosition.y += profile.bodyHeight / 2.0f / kPpm;
+  _snapshot.velocity = body->GetLinearVelocity();
+
   Character* lockedOnTarget = _character->getLockedOnTarget();
+  _snapshot.hasTarget = _snapshot.isActive && _character->isAlerted()
+    && lockedOnTarget && !lockedOnTarget->isSetToKill();
+  _snapshot.isTargetInRange = !_character->getInRangeTargets().empty();
+  _snapshot.hasNavEdge = false;
 
-  if (_character->isAlerted() && lockedOnTarget && !lockedOnTarget->isSetToKill()) {
-    if (!inRangeTargets.empty()) { // is target within the attack range?
-      _character->attack();
-      if (inRangeTargets.empty()) {
-        _character->setLockedOnTarget(nullptr);
+  if (_snapshot.hasTarget) {
+    _snapshot.targetPosition = lockedOnTarget->getBody()->GetPosition();
+    // NavGraph::findPath() updates the shared path cache, so it's done here.
+    if (!_snapshot.isTargetInRange) {
+      if (const NavGraph::Edge* edge = getNextNavEdge(lockedOnTarget)) {
+        _snapshot.hasNavEdge = true;
+        _snapshot.navEdge = *edge;
+        _snapshot.navLandingSpan = GameMapManager::getInstance()->getGameMap()->getNavGraph().getSpan(edge->to);
+        _snapshot.isOffNavSpan = _isOffNavSpan;
       }
-    } else if (std::abs(_character->getBody()->GetPosition().x - lockedOnTarget->getBody()->GetPosition().x) > .25f) {
+    }
+  }
+
+  _snapshot.occupancyGrid = &GameMapManager::getInstance()->getGameMap()->getOccupancyGrid();
+}
+
+void Bot::decide() {
+  _decision.commands = 0;
+
+  if (!_snapshot.isActive) {
+    return;
+  }
+
+  if (_snapshot.hasTarget) {
+    if (_snapshot.isTargetInRange) { // is target within the attack range?
+      _decision.commands |= Command::ATTACK;
+    } else if (_snapshot.hasNavEdge) {
+      // If the target is on another span, follow the path toward it.
+      followNavEdge(_snapshot.navEdge);
+    } else if (std::abs(_snapshot.position.x - _snapshot.targetPosition.x) > .25f) {
       // If the target isn't within attack range, move toward it until attackable
-      moveToTarget(lockedOnTarget);
-      jumpIfStucked(delta, .1f);
+      moveToTarget();
+      jumpIfStucked(.1f);
     }
   } else {
-    moveRandomly(delta, 0, 5, 0, 5);
+    moveRandomly(0, 5, 0, 5);
   }
 }
 
-void Bot::moveToTarget(Character* target) {
-  b2Body* thisBody = _character->getBody();
-  b2Body* targetBody = target->getBody();
+void Bot::applyDecision() {
+  uint8_t commands = _decision.commands;
+  _isMoving = commands & (Command::MOVE_LEFT | Command::MOVE_RIGHT);
 
-  if (thisBody->GetPosition().x > targetBody->GetPosition().x) {
+  // Another bot's decision may have changed this character since the snapshot.
+  if (!commands || _character->isSetToKill()) {
+    return;
+  }
+
+  if (commands & Command::MOVE_LEFT) {
     _character->moveLeft();
-  } else {
+  } else if (commands & Command::MOVE_RIGHT) {
     _character->moveRight();
   }
+
+  if (commands & Command::JUMP_DOWN) {
+    _character->jumpDown();
+  }
+  if (commands & Command::JUMP) {
+    _character->jump();
+  }
+
+  if (commands & Command::ATTACK) {
+    _character->attack();
+    if (_character->getInRangeTargets().empty()) {
+      _character->setLockedOnTarget(nullptr);
+    }
+  }
 }
 
-void Bot::moveRandomly(float delta, int minMoveDuration, int maxMoveDuration, int minWaitDuration, int maxWaitDuration) {
+
+void Bot::moveToTarget() {
+  if (_snapshot.position.x > _snapshot.targetPosition.x) {
+    _decision.commands |= Command::MOVE_LEFT;
+  } else {
+    _decision.commands |= Command::MOVE_RIGHT;
+  }
+}
+
+void Bot::moveRandomly(int minMoveDuration, int maxMoveDuration, int minWaitDuration, int maxWaitDuration) {
   // If the character has finished moving and waiting, regenerate random values for
   // _moveDuration and _waitDuration within the specified range.
   if (_moveTimer >= _moveDuration && _waitTimer >= _waitDuration) {
-    _isMovingRight = static_cast<bool>(rand_util::randInt(0, 1));
-    _moveDuration = rand_util::randInt(minMoveDuration, maxMoveDuration);
-    _waitDuration = rand_util::randInt(minWaitDuration, maxWaitDuration);
+    _isMovingRight = static_cast<bool>(_rng.randInt(0, 1));
+    _moveDuration = _rng.randInt(minMoveDuration, maxMoveDuration);
+    _waitDuration = _rng.randInt(minWaitDuration, maxWaitDuration);
     _moveTimer = 0;
     _waitTimer = 0;
   }
 
   if (_moveTimer < _moveDuration) {
-    if (_isMovingRight) {
-      _character->moveRight();
-    } else {
-      _character->moveLeft();
+    // Turn around at ledges instead of walking off them.
+    if (!_snapshot.isJumping
+        && !_snapshot.occupancyGrid->hasGroundAhead(_snapshot.feetPosition, _isMovingRight, _kMaxPatrolDrop)) {
+      reverseDirection();
     }
+
+    _decision.commands |= (_isMovingRight) ? Command::MOVE_RIGHT : Command::MOVE_LEFT;
     // Make sure the character doesn't get stucked somewhere along the way.
-    jumpIfStucked(delta, .5f);
-    _moveTimer += delta;
+    jumpIfStucked(.5f);
+    _moveTimer += _snapshot.delta;
   } else {
-    _waitTimer += delta;
+    _waitTimer += _snapshot.delta;
   }
 }
 
-void Bot::jumpIfStucked(float delta, float checkInterval) {
-  b2Body* thisBody = _character->getBody();
-
+void Bot::jumpIfStucked(float checkInterval) {
   if (_calculateDistanceTimer > checkInterval) {
-    _lastTraveledDistance = std::abs(thisBody->GetPosition().x - _lastStoppedPosition.x);
-    _lastStoppedPosition.Set(thisBody->GetPosition().x, thisBody->GetPosition().y);
-    if (_lastTraveledDistance == 0) {
-      _character->jump();
+    _lastTraveledDistance = std::abs(_snapshot.position.x - _lastStoppedPosition.x);
+    _lastStoppedPosition = _snapshot.position;
+    // Don't bother jumping if there's a ceiling right above.
+    if (_lastTraveledDistance == 0 && !_snapshot.occupancyGrid->hasCeiling(_snapshot.headPosition, _kMinJumpClearance)) {
+      _decision.commands |= Command::JUMP;
     }
     _calculateDistanceTimer = 0;
   } else {
-    _calculateDistanceTimer += delta;
+    _calculateDistanceTimer += _snapshot.delta;
+  }
+}
+
+void Bot::followNavEdge(const NavGraph::Edge& edge) {
+  float dx = edge.x - _snapshot.position.x;
+  bool hasTakenOff = _snapshot.isOffNavSpan
+    || (edge.type == NavGraph::EdgeType::JUMP && _snapshot.isJumping);
+
+  // Walk toward the takeoff point.
+  if (!hasTakenOff && std::abs(dx) > .1f) {
+    _decision.commands |= (dx > 0) ? Command::MOVE_RIGHT : Command::MOVE_LEFT;
+    return;
+  }
+
+  switch (edge.type) {
+    case NavGraph::EdgeType::WALK:
+      // Keep on walking past the takeoff point.
+      _decision.commands |= (_snapshot.isFacingRight) ? Command::MOVE_RIGHT : Command::MOVE_LEFT;
+      break;
+    case NavGraph::EdgeType::DROP:
+      _decision.commands |= Command::JUMP_DOWN;
+      break;
+    case NavGraph::EdgeType::FALL:
+    case NavGraph::EdgeType::JUMP: {
+      // From the takeoff point on, steer toward the nearest x on the landing span
+      // instead of back toward the takeoff point.
+      const NavGraph::Span& landingSpan = _snapshot.navLandingSpan;
+      float landingX = std::max(landingSpan.left, std::min(_snapshot.position.x, landingSpan.right));
+      float landingDx = landingX - _snapshot.position.x;
+      if (std::abs(landingDx) > .1f) {
+        _decision.commands |= (landingDx > 0) ? Command::MOVE_RIGHT : Command::MOVE_LEFT;
+      } else if (edge.type == NavGraph::EdgeType::FALL && !_snapshot.isOffNavSpan) {
+        // Keep on walking until off the edge.
+        _decision.commands |= (_snapshot.isFacingRight) ? Command::MOVE_RIGHT : Command::MOVE_LEFT;
+      }
+
+      if (edge.type != NavGraph::EdgeType::JUMP) {
+        break;
+      }
+      if (!_snapshot.isJumping) {
+        _decision.commands |= Command::JUMP;
+      } else if (_snapshot.canDoubleJump && !_snapshot.isDoubleJumping && _snapshot.velocity.y <= 0) {
+        // Double jump at the apex of the first jump.
+        _decision.commands |= Command::JUMP;
+      }
+      break;
+    }
+    default:
+      break;
   }
 }
 
@@ -99,4 +277,53 @@ void Bot::reverseDirection() {
   _isMovingRight = !_isMovingRight;
 }
 
+int Bot::getBotId() const {
+  return _botId;
+}
+
+
+const NavGraph::Edge* Bot::getNextNavEdge(Character* target) {
+  NavGraph& navGraph = GameMapManager::getInstance()->getGameMap()->getNavGraph();
+  int fromSpan = navGraph.findSpan(getFeetPosition(_character));
+  int toSpan = navGraph.findSpan(getFeetPosition(target));
+
+  // While this bot is in the air (jumping/falling along an edge),
+  // keep following that edge.
+  _isOffNavSpan = fromSpan < 0;
+  if (_isOffNavSpan) {
+    return (_navEdge >= 0) ? &navGraph.getEdge(_navEdge) : nullptr;
+  }
+
+  if (fromSpan != _navFromSpan || (toSpan >= 0 && toSpan != _navToSpan)) {
+    _navFromSpan = fromSpan;
+    _navToSpan = (toSpan >= 0) ? toSpan : _navToSpan;
+    _navPath = (_navToSpan >= 0 && _navToSpan != fromSpan) ? navGraph.findPath(fromSpan, _navToSpan, getNavCapability()) : nullptr;
+  }
+
+  _navEdge = (_navPath) ? _navPath->front() : -1;
+  return (_navEdge >= 0) ? &navGraph.getEdge(_navEdge) : nullptr;
+}
+
+NavGraph::Capability Bot::getNavCapability() const {
+  // Character::jump() applies an impulse of `jumpHeight`, so the initial
+  // velocity is jumpHeight / mass, and the apex is v^2 / 2g.
+  const Character::Profile& profile = _character->getCharacterProfile();
+  float g = std::abs(kGravity);
+  float v = profile.jumpHeight / _character->getBody()->GetMass();
+  float height = v * v / (2 * g);
+  float airTime = 2 * v / g;
+
+  if (profile.canDoubleJump) {
+    height *= 2;
+    airTime *= 2;
+  }
+  return {height, profile.moveSpeed * 2 * airTime};
+}
+
+b2Vec2 Bot::getFeetPosition(Character* character) {
+  b2Vec2 feetPos = character->getBody()->GetPosition();
+  feetPos.y -= character->getCharacterProfile().bodyHeight / 2.0f / kPpm;
+  return feetPos;
+}
+
 } // namespace vigilante
@@ -2,33 +2,135 @@
 #ifndef VIGILANTE_BOT_H_
 #define VIGILANTE_BOT_H_
 
+#include <cstdint>
+
 #include <Box2D/Box2D.h>
 #include "Character.h"
+#include "map/NavGraph.h"
+#include "map/OccupancyGrid.h"
+#include "util/Rng.h"
 
 namespace vigilante {
 
+// The AI of a bot runs in three phases, driven by GameMapManager::update():
+// 1. captureSnapshot() (main thread) copies everything the AI needs to know
+//    about the world into a Bot::Snapshot.
+// 2. decide() (worker threads) reads only that snapshot (and the immutable
+//    OccupancyGrid) and writes a Bot::Decision. It must not touch b2World,
+//    cocos2d or any other actor.
+// 3. applyDecision() (main thread) executes the decided commands on the character.
+// Bots are snapshotted and applied in the order of their ids, so the result
+// doesn't depend on how decide() is scheduled across threads.
 class Bot {
  public:
+  enum Command : uint8_t {
+    MOVE_LEFT  = 0x01,
+    MOVE_RIGHT = 0x02,
+    JUMP       = 0x04,
+    JUMP_DOWN  = 0x08,
+    ATTACK     = 0x10
+  };
+
+  struct Snapshot {
+    float delta;
+    bool isActive; // false if killed or attacking
+    bool isFacingRight;
+    bool isJumping;
+    bool isDoubleJumping;
+    bool canDoubleJump;
+    b2Vec2 position;
+    b2Vec2 feetPosition;
+    b2Vec2 headPosition;
+    b2Vec2 velocity;
+
+    bool hasTarget; // is this bot alerted and locked on an alive target?
+    bool isTargetInRange; // is the target within the attack range?
+    b2Vec2 targetPosition;
+    bool hasNavEdge; // is the target on another span?
+    NavGraph::Edge navEdge;
+    NavGraph::Span navLandingSpan; // the span navEdge leads to
+    bool isOffNavSpan; // has this bot left the span (i.e., is it in the air along navEdge)?
+
+    const OccupancyGrid* occupancyGrid;
+  };
+
+  struct Decision {
+    uint8_t commands; // Bot::Command bitmask
+  };
+
   explicit Bot(Character* c);
   virtual ~Bot() = default;
 
-  virtual void act(float delta);
-  void moveToTarget(Character* target);
-  void moveRandomly(float delta, int minMoveDuration, int maxMoveDuration, int minWaitDuration, int maxWaitDuration);
-  void jumpIfStucked(float delta, float checkInterval);
+  // Called every frame. The AI of this bot is scheduled at a rate based on
+  // the distance to the player and the alert state (see Bot::getTickInterval()),
+  // with the delta accumulated since the last tick. Ticks of different bots
+  // are staggered across frames, so the AI cost per frame stays flat.
+  void tick(float delta);
+
+  void captureSnapshot();
+  void decide();
+  void applyDecision();
+
   void reverseDirection();
-  
+  int getBotId() const;
+
+ protected:
+  // Called on the main thread right before the snapshot is captured.
+  // Override this to update the perception (e.g., lock on a target).
+  virtual void perceive() {}
+
+  static b2Vec2 getFeetPosition(Character* character);
+
  private:
+  int getTickInterval() const;
+
+  // The following are called from Bot::decide() only.
+  void moveToTarget();
+  void moveRandomly(int minMoveDuration, int maxMoveDuration, int minWaitDuration, int maxWaitDuration);
+  void jumpIfStucked(float checkInterval);
+  void followNavEdge(const NavGraph::Edge& edge);
+
+  // Pursuit across spans (see NavGraph.h).
+  // Returns nullptr if the target is on the same span (or unreachable).
+  const NavGraph::Edge* getNextNavEdge(Character* target);
+  NavGraph::Capability getNavCapability() const;
+
+  static const int _kOnScreenTickInterval;
+  static const int _kOffScreenTickInterval;
+  static const float _kMaxPatrolDrop; // patrolling bots turn around at drops deeper than this
+  static const float _kMinJumpClearance;
+  static int _botIdCounter;
+
   Character* _character;
+  int _botId;
+
+  // The following variables are used in Bot::tick()
+  int _frameCount;
+  float _pendingDelta;
+  bool _isMoving; // is this bot moving (as of its last decision)?
 
-  // The following variables are used in BotActions::moveRandomly()
+  Bot::Snapshot _snapshot;
+  Bot::Decision _decision;
+  // The shared streams in rand_util aren't thread-safe,
+  // so each bot has its own generator for decide().
+  Rng _rng;
+
+  // The following variables are used in Bot::moveRandomly()
   bool _isMovingRight;
   float _moveDuration;
   float _moveTimer;
   float _waitDuration;
   float _waitTimer;
 
-  // The following variables are used in BotActions::jumpIfStucked()
+  // The following variables are used in Bot::getNextNavEdge()
+  // The path is only replanned when either span changes.
+  const NavGraph::Path* _navPath;
+  int _navFromSpan;
+  int _navToSpan;
+  int _navEdge;
+  bool _isOffNavSpan;
+
+  // The following variables are used in Bot::jumpIfStucked()
   b2Vec2 _lastStoppedPosition;
   float _lastTraveledDistance;
   float _calculateDistanceTimer;
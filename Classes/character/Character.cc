@@ -1,11 +1,16 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "Character.h"
 
+#include <string>
+#include <algorithm>
+
 #include <json/document.h>
+#include "Animator.h"
+#include "CompositeAtlasCache.h"
 #include "AssetManager.h"
 #include "Constants.h"
+#include "input/HotkeyManager.h"
 #include "map/GameMapManager.h"
-#include "ui/hud/Hud.h"
 #include "ui/floating_damages/FloatingDamages.h"
 #include "util/box2d/b2BodyBuilder.h"
 #include "util/CallbackUtil.h"
@@ -21,17 +26,13 @@ using std::function;
 using std::ifstream;
 using cocos2d::Vector;
 using cocos2d::Director;
-using cocos2d::Sequence;
-using cocos2d::CallFunc;
-using cocos2d::Repeat;
-using cocos2d::RepeatForever;
+using cocos2d::Node;
 using cocos2d::Animation;
-using cocos2d::Animate;
-using cocos2d::Action;
 using cocos2d::Sprite;
 using cocos2d::SpriteFrame;
 using cocos2d::SpriteFrameCache;
 using cocos2d::SpriteBatchNode;
+using cocos2d::EventKeyboard;
 using rapidjson::Document;
 
 namespace vigilante {
@@ -80,22 +81,34 @@ Character::Character(const string& jsonFileName)
       _isAlerted(),
       _inventory(),
       _equipmentSlots(),
-      _interactableObject(),
+      _itemStackIndices(),
+      _inventoryVersion(1),
+      _equipmentVersion(1),
       _portal(),
       _skills(),
+      _skillsVersion(1),
       _currentlyUsedSkill(),
       _bodyExtraAttackAnimations(),
       _equipmentExtraAttackAnimations(),
       _equipmentSprites(),
       _equipmentSpritesheets(),
       _equipmentAnimations(),
-      _skillBodyAnimations() {}
+      _skillBodyAnimations(),
+      _skillEquipmentAnimations(),
+      _bakedSprite(),
+      _bakedAnimations(),
+      _bakedExtraAttackAnimations(),
+      _hasBakedAnimations(),
+      _animatorHandle(Animator::_kInvalidHandle),
+      _characterNode(Node::create()) {
+  // _characterNode outlives its GameMap layer (e.g., removeFromMap() and
+  // showOnMap() again), so it is retained by this character.
+  _characterNode->retain();
+}
 
 Character::~Character() {
-  // Delete all items from inventory and equipment slots.
-  for (auto item : _itemMapper) {
-    delete item.second;
-  }
+  _characterNode->release();
+
   // Delete all skills.
   for (auto skill : _skills) {
     delete skill;
@@ -109,51 +122,42 @@ void Character::removeFromMap() {
   }
   _isShownOnMap = false;
   GameMapManager::getInstance()->getGameMap()->getDynamicActors().erase(this);
+  GameMapManager::getInstance()->getGameMap()->getSpatialHash().remove(this);
 
   if (!_isKilled) {
     _body->GetWorld()->DestroyBody(_body);
   }
 
   GameMapManager* gmMgr = GameMapManager::getInstance();
-  gmMgr->getLayer()->removeChild(_bodySpritesheet);
-  for (auto equipment : _equipmentSlots) {
-    if (equipment) {
-      Equipment::Type type = equipment->getEquipmentProfile().equipmentType;
-      gmMgr->getLayer()->removeChild(_equipmentSpritesheets[type]);
-    }
-  }
+  gmMgr->getAnimator()->remove(_animatorHandle);
+  _animatorHandle = Animator::_kInvalidHandle;
+
+  // The equipment spritesheets are kept in _characterNode,
+  // but the body spritesheet will be recreated in showOnMap().
+  gmMgr->getLayer()->removeChild(_characterNode);
+  _characterNode->removeChild(_bodySpritesheet);
+  _characterNode->removeChild(_bakedSprite);
+  _bakedSprite = nullptr;
 }
 
 void Character::update(float delta) {
   if (_isKilled) return;
 
-  // Flip the sprite if needed.
-  if (!_isFacingRight && !_bodySprite->isFlippedX()) {
-    _bodySprite->setFlippedX(true);
+  // Flip the character (body and equipment) if needed.
+  if (!_isFacingRight && _characterNode->getScaleX() > 0) {
+    _characterNode->setScaleX(-1);
     b2CircleShape* shape = static_cast<b2CircleShape*>(_fixtures[FixtureType::WEAPON]->GetShape());
     shape->m_p = {-_characterProfile.attackRange / kPpm, 0};
-  } else if (_isFacingRight && _bodySprite->isFlippedX()) {
-    _bodySprite->setFlippedX(false);
+  } else if (_isFacingRight && _characterNode->getScaleX() < 0) {
+    _characterNode->setScaleX(1);
     b2CircleShape* shape = static_cast<b2CircleShape*>(_fixtures[FixtureType::WEAPON]->GetShape());
     shape->m_p = {_characterProfile.attackRange / kPpm, 0};
   }
 
-  // Sync the body sprite with its b2body.
+  // Sync the character (body and equipment) with its b2body.
   b2Vec2 b2bodyPos = _body->GetPosition();
-  _bodySprite->setPosition(b2bodyPos.x * kPpm, b2bodyPos.y * kPpm + _characterProfile.spriteOffsetY);
-
-  // Sync the equipment sprites with its b2body.
-  for (int i = 0; i < Equipment::Type::SIZE; i++) {
-    Equipment::Type type = static_cast<Equipment::Type>(i);
-    if (_equipmentSlots[type]) {
-      if (!_isFacingRight && !_equipmentSprites[type]->isFlippedX()) {
-        _equipmentSprites[type]->setFlippedX(true);
-      } else if (_isFacingRight && _equipmentSprites[type]->isFlippedX()) {
-        _equipmentSprites[type]->setFlippedX(false);
-      }
-      _equipmentSprites[type]->setPosition(b2bodyPos.x * kPpm, b2bodyPos.y * kPpm + _characterProfile.spriteOffsetY);
-    }
-  }
+  _characterNode->setPosition(b2bodyPos.x * kPpm, b2bodyPos.y * kPpm + _characterProfile.spriteOffsetY);
+  GameMapManager::getInstance()->getGameMap()->getSpatialHash().update(this, _fixtures[FixtureType::BODY]->GetFilterData().categoryBits);
 
   // Handle stats regeneration.
   _statsRegenTimer += delta;
@@ -162,7 +166,6 @@ void Character::update(float delta) {
     regenHealth(_baseRegenDeltaHealth);
     regenMagicka(_baseRegenDeltaMagicka);
     regenStamina(_baseRegenDeltaStamina);
-    Hud::getInstance()->updateStatusBars();
   }
 
   // Don't update character's state if he/she is using skill.
@@ -212,7 +215,7 @@ void Character::update(float delta) {
       case State::KILLED:
         runAnimation(State::KILLED, [=]() {
           // Execute after the KILLED animation is finished.
-          GameMapManager::getInstance()->getWorld()->DestroyBody(_body);
+          GameMapManager::getInstance()->getWorldCommandBuffer()->destroyBody(_body);
           _isKilled = true;
         });
         break;
@@ -286,8 +289,27 @@ void Character::defineBody(b2BodyType bodyType, short bodyCategoryBits, short bo
 
 void Character::defineTexture(const string& bodyTextureResDir, float x, float y) {
   loadBodyAnimations(bodyTextureResDir);
-  _bodySprite->setPosition(x * kPpm, y * kPpm + _characterProfile.spriteOffsetY);
+  _characterNode->addChild(_bodySpritesheet);
+  _characterNode->setPosition(x * kPpm, y * kPpm + _characterProfile.spriteOffsetY);
+
+  // The baked sprite cannot be a child of _bodySpritesheet
+  // since its frames come from another texture.
+  _bakedSprite = Sprite::create();
+  _bakedSprite->setScaleX(_characterProfile.spriteScaleX);
+  _bakedSprite->setScaleY(_characterProfile.spriteScaleY);
+  _bakedSprite->setVisible(false);
+  _characterNode->addChild(_bakedSprite);
+
+  // Register body and equipment sprites to the animator.
+  Animator* animator = GameMapManager::getInstance()->getAnimator();
+  _animatorHandle = animator->add();
+  animator->setLayer(_animatorHandle, 0, _bodySprite);
+  for (int i = 0; i < Equipment::Type::SIZE; i++) {
+    Equipment::Type type = static_cast<Equipment::Type>(i);
+    animator->setLayer(_animatorHandle, getEquipmentAnimatorLayer(type), _equipmentSprites[type]);
+  }
 
+  bakeEquipmentAnimations();
   runAnimation(State::IDLE_SHEATHED);
 }
 
@@ -314,8 +336,7 @@ void Character::loadBodyAnimations(const string& bodyTextureResDir) {
   _bodyExtraAttackAnimations[0] = createAnimation(bodyTextureResDir, "attacking2", _characterProfile.frameInterval[State::ATTACKING] / kPpm, fallback);
 
   // Select a frame as default look for this sprite.
-  string framePrefix = StaticActor::getLastDirName(bodyTextureResDir);
-  _bodySprite = Sprite::createWithSpriteFrameName(framePrefix + "_idle_sheathed/0.png");
+  _bodySprite = Sprite::createWithSpriteFrame(_bodyAnimations[State::IDLE_SHEATHED]->getFrames().front()->getSpriteFrame());
   _bodySprite->setScaleX(_characterProfile.spriteScaleX);
   _bodySprite->setScaleY(_characterProfile.spriteScaleY);
 
@@ -323,7 +344,7 @@ void Character::loadBodyAnimations(const string& bodyTextureResDir) {
   _bodySpritesheet->getTexture()->setAliasTexParameters(); // disable texture antialiasing
 }
 
-void Character::loadEquipmentAnimations(Equipment* equipment) {
+void Character::loadEquipmentAnimations(const Equipment* equipment) {
   Equipment::Type type = equipment->getEquipmentProfile().equipmentType;
   const string& textureResDir = equipment->getItemProfile().textureResDir;
   _equipmentSpritesheets[type] = SpriteBatchNode::create(textureResDir + "/spritesheet.png");
@@ -347,114 +368,184 @@ void Character::loadEquipmentAnimations(Equipment* equipment) {
   // Load extra attack animations.
   _equipmentExtraAttackAnimations[type][0] = createAnimation(textureResDir, "attacking2", _characterProfile.frameInterval[State::ATTACKING] / kPpm, fallback);
 
-  string framePrefix = StaticActor::getLastDirName(textureResDir);
-  _equipmentSprites[type] = Sprite::createWithSpriteFrameName(framePrefix + "_idle_sheathed/0.png");
+  _equipmentSprites[type] = Sprite::createWithSpriteFrame(_equipmentAnimations[type][State::IDLE_SHEATHED]->getFrames().front()->getSpriteFrame());
   _equipmentSprites[type]->setScaleX(_characterProfile.spriteScaleX);
   _equipmentSprites[type]->setScaleY(_characterProfile.spriteScaleY);
 
   _equipmentSpritesheets[type]->addChild(_equipmentSprites[type]);
   _equipmentSpritesheets[type]->getTexture()->setAliasTexParameters();
+  _characterNode->addChild(_equipmentSpritesheets[type], graphical_layers::kEquipment - type);
+
+  GameMapManager::getInstance()->getAnimator()->setLayer(_animatorHandle, getEquipmentAnimatorLayer(type), _equipmentSprites[type]);
 }
 
 
 void Character::runAnimation(State state, bool loop) const {
-  auto targetAnimation = _bodyAnimations[state];
+  runAnimation(state, loop, nullptr);
+}
+
+void Character::runAnimation(State state, const function<void ()>& func) const {
+  runAnimation(state, false, func);
+}
+
+void Character::runAnimation(State state, bool loop, const function<void ()>& func) const {
+  Animator::Layers animations = {};
+  animations[0] = _bodyAnimations[state];
 
   int attackAnimationIdx = 0;
   if (state == State::ATTACKING) {
-    int i = rand_util::randInt(0, 1);
+    int i = rand_util::randInt(0, 1, rand_util::Stream::COSMETIC);
     if (i >= 1) {
       // Pick the animation from _extraAttackAnimations array.
-      targetAnimation = _bodyExtraAttackAnimations[i - 1];
+      animations[0] = _bodyExtraAttackAnimations[i - 1];
     }
     attackAnimationIdx = i;
   }
 
-  auto animation = Animate::create(targetAnimation);
-  Action* action = nullptr;
-  if (loop) {
-    action = RepeatForever::create(animation);
-  } else {
-    action = Repeat::create(animation, 1);
+  // The baked animation already contains all equipment.
+  showBakedSprite(_hasBakedAnimations);
+  if (_hasBakedAnimations) {
+    animations[0] = (attackAnimationIdx > 0) ? _bakedExtraAttackAnimations[attackAnimationIdx - 1] : _bakedAnimations[state];
+    GameMapManager::getInstance()->getAnimator()->play(_animatorHandle, animations, loop, func);
+    return;
   }
 
-  // Update body animation.
-  _bodySprite->stopAllActions();
-  _bodySprite->runAction(action);
-
-  // Update equipment animation.
+  // Equipment animations share the same clock as the body animation,
+  // so they're always frame-locked with the body.
   for (int i = 0; i < Equipment::Type::SIZE; i++) {
     Equipment::Type type = static_cast<Equipment::Type>(i);
     if (_equipmentSlots[type]) {
-      _equipmentSprites[type]->stopAllActions();
-
-      auto targetAnimation = _equipmentAnimations[type][state];
+      Animation* targetAnimation = _equipmentAnimations[type][state];
       if (state == State::ATTACKING && attackAnimationIdx > 0) {
         targetAnimation = _equipmentExtraAttackAnimations[type][attackAnimationIdx - 1];
       }
-
-      auto animate = Animate::create(targetAnimation);
-      Action* action = nullptr;
-      if (loop) {
-        action = RepeatForever::create(animate);
-      } else {
-        action = Repeat::create(animate, 1);
-      }
-      _equipmentSprites[type]->runAction(action);
+      animations[getEquipmentAnimatorLayer(type)] = targetAnimation;
     }
   }
+
+  GameMapManager::getInstance()->getAnimator()->play(_animatorHandle, animations, loop, func);
 }
 
-void Character::runAnimation(State state, const function<void ()>& func) const {
-  auto animate = Animate::create(_bodyAnimations[state]);
-  auto callback = CallFunc::create(func);
-  _bodySprite->stopAllActions();
-  _bodySprite->runAction(Sequence::createWithTwoActions(animate, callback));
+void Character::runAnimation(Atom framesName, float interval) {
+  Animator::Layers animations = {};
+
+  // Skill animations aren't baked, so the body and equipment are drawn separately.
+  showBakedSprite(false);
+
+  // Try to load the target framesName under this character's textureResDir.
+  Animation*& bodyAnimation = _skillBodyAnimations[framesName];
+  if (!bodyAnimation) {
+    Animation* fallback = _bodyAnimations[State::ATTACKING];
+    // Cache this skill animation (body).
+    bodyAnimation = createAnimation(_characterProfile.textureResDir, framesName.str(), interval, fallback);
+  }
+  animations[0] = bodyAnimation;
 
   // Update equipment animation.
   for (int i = 0; i < Equipment::Type::SIZE; i++) {
     Equipment::Type type = static_cast<Equipment::Type>(i);
     if (_equipmentSlots[type]) {
-      _equipmentSprites[type]->stopAllActions();
+      const Item::Profile& itemProfile = _equipmentSlots[type]->getItemProfile();
 
-      auto animate = Animate::create(_equipmentAnimations[type][state]);
-      Action* action = Repeat::create(animate, 1);
-      _equipmentSprites[type]->runAction(action);
+      Animation*& equipmentAnimation = _skillEquipmentAnimations[{itemProfile.textureResDirAtom, framesName}];
+      if (!equipmentAnimation) {
+        Animation* fallback = _equipmentAnimations[type][State::ATTACKING];
+        // Cache this skill animation (equipment).
+        equipmentAnimation = createAnimation(itemProfile.textureResDir, framesName.str(), interval, fallback);
+      }
+      animations[getEquipmentAnimatorLayer(type)] = equipmentAnimation;
     }
   }
+
+  GameMapManager::getInstance()->getAnimator()->play(_animatorHandle, animations, false);
 }
 
-void Character::runAnimation(const string& framesName, float interval) {
-  // Try to load the target framesName under this character's textureResDir.
-  Animation* bodyAnimation = nullptr;
-  
-  if (_skillBodyAnimations.find(framesName) == _skillBodyAnimations.end()) {
-    Animation* fallback = _bodyAnimations[State::ATTACKING];
-    bodyAnimation = createAnimation(_characterProfile.textureResDir, framesName, interval, fallback);
-    // Cache this skill animation (body).
-    _skillBodyAnimations.insert({framesName, bodyAnimation});
-  } else {
-    bodyAnimation = _skillBodyAnimations[framesName];
-  }
+int Character::getEquipmentAnimatorLayer(Equipment::Type type) {
+  static_assert(1 + Equipment::Type::SIZE <= Animator::_kMaxLayers, "Animator doesn't have enough layers for all equipment slots");
+  // Layer 0 is reserved for the body sprite.
+  return 1 + type;
+}
 
-  _bodySprite->stopAllActions();
-  _bodySprite->runAction(Repeat::create(Animate::create(bodyAnimation), 1));
+void Character::bakeEquipmentAnimations() {
+  _hasBakedAnimations = false;
+  if (!_characterProfile.bakesEquipmentSprites || _animatorHandle == Animator::_kInvalidHandle) {
+    return;
+  }
 
-  // Update equipment animation.
-  for (int i = 0; i < Equipment::Type::SIZE; i++) {
+  // The atlas is shared by all characters with the same body and equipment.
+  // Equipment are listed from bottom to top (see loadEquipmentAnimations()).
+  string signature = _characterProfile.textureResDir;
+  vector<Equipment::Type> equipmentTypes;
+  for (int i = Equipment::Type::SIZE - 1; i >= 0; i--) {
     Equipment::Type type = static_cast<Equipment::Type>(i);
     if (_equipmentSlots[type]) {
-      _equipmentSprites[type]->stopAllActions();
+      signature += "|" + _equipmentSlots[type]->getItemProfile().textureResDir;
+      equipmentTypes.push_back(type);
+    }
+  }
+
+  // A naked character is already a single sprite.
+  if (equipmentTypes.empty()) {
+    return;
+  }
+
+  // The frame intervals are baked into the atlas as well. The sprite scale isn't,
+  // but is kept in the signature so that an atlas is only shared by identical sprites.
+  for (float interval : _characterProfile.frameInterval) {
+    signature += "|" + std::to_string(interval);
+  }
+  signature += "|" + std::to_string(_characterProfile.spriteScaleX) + "x" + std::to_string(_characterProfile.spriteScaleY);
+
+  vector<CompositeAtlasCache::Clip> clips;
+  for (int i = 0; i < State::STATE_SIZE; i++) {
+    CompositeAtlasCache::Clip clip = {_bodyAnimations[i]};
+    for (auto type : equipmentTypes) {
+      clip.push_back(_equipmentAnimations[type][i]);
+    }
+    clips.push_back(clip);
+  }
+  for (size_t i = 0; i < _bodyExtraAttackAnimations.size(); i++) {
+    CompositeAtlasCache::Clip clip = {_bodyExtraAttackAnimations[i]};
+    for (auto type : equipmentTypes) {
+      clip.push_back(_equipmentExtraAttackAnimations[type][i]);
+    }
+    clips.push_back(clip);
+  }
+
+  CompositeAtlasCache* cache = GameMapManager::getInstance()->getCompositeAtlasCache();
+  const vector<Animation*>* bakedAnimations = cache->bake(signature, clips);
+  if (!bakedAnimations) {
+    return;
+  }
 
-      const string& textureResDir = _equipmentSlots[type]->getItemProfile().textureResDir;
-      Animation* fallback = _equipmentAnimations[type][ATTACKING];
+  std::copy(bakedAnimations->begin(), bakedAnimations->begin() + State::STATE_SIZE, _bakedAnimations.begin());
+  std::copy(bakedAnimations->begin() + State::STATE_SIZE, bakedAnimations->end(), _bakedExtraAttackAnimations.begin());
+  _hasBakedAnimations = true;
+}
 
-      // TODO: cache these equipment skill animation
-      Animation* animation = createAnimation(textureResDir, framesName, interval, fallback);
-      _equipmentSprites[type]->stopAllActions();
-      _equipmentSprites[type]->runAction(Animate::create(animation));
+void Character::rebakeEquipmentAnimations() {
+  // The animation being played may come from the cleared atlases,
+  // so stop it and rerun the animation of the current state next time in Character::update().
+  if (_bakedSprite && _bakedSprite->isVisible()) {
+    GameMapManager::getInstance()->getAnimator()->play(_animatorHandle, Animator::Layers(), false);
+    _currentState = State::FORCE_UPDATE;
+  }
+  bakeEquipmentAnimations();
+}
+
+void Character::showBakedSprite(bool shown) const {
+  if (!_bakedSprite) {
+    return;
+  }
+
+  _bakedSprite->setVisible(shown);
+  _bodySpritesheet->setVisible(!shown);
+  for (int i = 0; i < Equipment::Type::SIZE; i++) {
+    if (_equipmentSlots[i]) {
+      _equipmentSpritesheets[i]->setVisible(!shown);
     }
   }
+  GameMapManager::getInstance()->getAnimator()->setLayer(_animatorHandle, 0, (shown) ? _bakedSprite : _bodySprite);
 }
 
 
@@ -603,14 +694,13 @@ void Character::activateSkill(Skill* skill) {
     _currentState = State::FORCE_UPDATE;
   }, skill->getSkillProfile().framesDuration);
 
-  if (skill->getSkillProfile().characterFramesName != "") {
+  if (!skill->getSkillProfile().characterFramesName.empty()) {
     Skill::Profile& skillProfile = skill->getSkillProfile();
     runAnimation(skillProfile.characterFramesName, skillProfile.frameInterval / kPpm);
   }
 
   // Create an extra copy of this skill object and activate it.
   Skill::create(skill->getSkillProfile().jsonFileName, this)->activate();
-  Hud::getInstance()->updateStatusBars();
 }
 
 void Character::knockBack(Character* target, float forceX, float forceY) const {
@@ -624,7 +714,7 @@ void Character::inflictDamage(Character* target, int damage) {
 }
 
 void Character::receiveDamage(Character* source, int damage) {
-  if (_isInvincible) {
+  if (_isInvincible || _isSetToKill) {
     return;
   }
 
@@ -633,8 +723,9 @@ void Character::receiveDamage(Character* source, int damage) {
 
   if (_characterProfile.health <= 0) {
     source->getInRangeTargets().erase(this);
-    Character::setCategoryBits(_fixtures[FixtureType::BODY], category_bits::kDestroyed);
+    GameMapManager::getInstance()->getWorldCommandBuffer()->setCategoryBits(_fixtures[FixtureType::BODY], category_bits::kDestroyed);
     _isSetToKill = true;
+    onKilled(source);
     // TODO: play killed sound.
   } else {
     // TODO: play hurt sound.
@@ -647,60 +738,68 @@ void Character::lockOn(Character* target) {
 }
 
 
-void Character::addItem(Item* item, int amount) {
+void Character::addItem(const Item* item, int amount) {
   if (!item) {
     return;
   }
 
-  // If this Item* does not exist in Inventory or EquipmentSlots yet, store it in _itemMapper.
-  // Otherwise, simply delete it and use the existing copy instead (saves memory).
-  Item* existingItemObj = getExistingItemObj(item);
+  vector<ItemStack>& itemStacks = _inventory[item->getItemProfile().itemType];
+  int index = getItemStackIndex(item);
 
-  if (!existingItemObj) {
-    existingItemObj = item;
-    _itemMapper[item->getItemProfile().name] = item;
-    existingItemObj->setAmount(amount);
+  if (index == -1) {
+    if (item->getId() >= (int) _itemStackIndices.size()) {
+      _itemStackIndices.resize(item->getId() + 1, -1);
+    }
+    _itemStackIndices[item->getId()] = itemStacks.size();
+    itemStacks.push_back({item, amount, EventKeyboard::KeyCode::KEY_NONE});
   } else {
-    existingItemObj->setAmount(existingItemObj->getAmount() + amount);
+    itemStacks[index].amount += amount;
   }
+  _inventoryVersion++;
+}
 
-  if (item != existingItemObj) {
-    delete item;
+void Character::removeItem(const Item* item, int amount) {
+  int index = getItemStackIndex(item);
+  if (index == -1) {
+    return;
   }
 
-  vector<Item*>& items = _inventory[item->getItemProfile().itemType];
-  if (std::find(items.begin(), items.end(), existingItemObj) == items.end()) {
-    items.push_back(existingItemObj);
+  vector<ItemStack>& itemStacks = _inventory[item->getItemProfile().itemType];
+  itemStacks[index].amount -= amount;
+  _inventoryVersion++;
+
+  if (itemStacks[index].amount > 0) {
+    return;
   }
-}
 
-void Character::removeItem(Item* item, int amount) {
-  vector<Item*>& items = _inventory[item->getItemProfile().itemType];
-  Item* existingItemObj = getExistingItemObj(item);
-  existingItemObj->setAmount(existingItemObj->getAmount() - amount);
+  // HotkeyManager must not keep an action for a stack which no longer exists.
+  if (static_cast<bool>(itemStacks[index].hotkey)) {
+    HotkeyManager::getInstance()->clearHotkeyAction(itemStacks[index].hotkey);
+  }
 
-  if (existingItemObj->getAmount() <= 0) {
-    items.erase(std::remove(items.begin(), items.end(), existingItemObj), items.end());
-    // We can safely delete this Item* if:
-    // 1. It is not an equipment, or...
-    // 2. It is an equipment, but no same item is currently equipped.
-    Equipment* equipment = dynamic_cast<Equipment*>(existingItemObj);
-    if (!equipment || (_equipmentSlots[equipment->getEquipmentProfile().equipmentType] != existingItemObj)) {
-      _itemMapper.erase(item->getItemProfile().name);
-      delete existingItemObj;
-    }
+  // Move the last stack into its place, so that the others needn't be reindexed.
+  _itemStackIndices[item->getId()] = -1;
+  if (index != (int) itemStacks.size() - 1) {
+    itemStacks[index] = itemStacks.back();
+    _itemStackIndices[itemStacks[index].item->getId()] = index;
   }
+  itemStacks.pop_back();
+}
+
+void Character::addItem(const string& itemJsonFileName, int amount) {
+  addItem(Item::getPrototype(itemJsonFileName), amount);
 }
 
-Item* Character::getExistingItemObj(Item* item) const {
-  // For each instance of an item, at most one copy is kept in the memory.
-  // This copy will be stored in _itemMapper (unordered_map<string, Item*>)
-  // Search time complexity: avg O(1), worst O(n).
-  auto it = _itemMapper.find(item->getItemProfile().name);
-  return (it != _itemMapper.end()) ? (*it).second : nullptr;
+void Character::removeItem(const string& itemJsonFileName, int amount) {
+  removeItem(Item::getPrototype(itemJsonFileName), amount);
 }
 
-void Character::useItem(Consumable* consumable) {
+int Character::getItemStackIndex(const Item* item) const {
+  int id = item->getId();
+  return (id < (int) _itemStackIndices.size()) ? _itemStackIndices[id] : -1;
+}
+
+void Character::useItem(const Consumable* consumable) {
   auto& profile = _characterProfile;
   const auto& consumableProfile = consumable->getConsumableProfile();
 
@@ -723,33 +822,41 @@ void Character::useItem(Consumable* consumable) {
   profile.moveSpeed += consumableProfile.bonusMoveSpeed;
   profile.jumpHeight += consumableProfile.bonusJumpHeight;
 
-  Hud::getInstance()->updateStatusBars();
   removeItem(consumable, 1);
 }
 
-void Character::equip(Equipment* equipment) {
+void Character::equip(const Equipment* equipment) {
   // If there's already an equipment in that slot, unequip it first.
   Equipment::Type type = equipment->getEquipmentProfile().equipmentType;
   if (_equipmentSlots[type]) {
     unequip(type);
   }
   _equipmentSlots[type] = equipment;
+  _equipmentVersion++;
   removeItem(equipment, 1);
 
   // Load equipment animations.
   loadEquipmentAnimations(equipment);
-  GameMapManager::getInstance()->getLayer()->addChild(_equipmentSpritesheets[type], graphical_layers::kEquipment - type);
+  bakeEquipmentAnimations();
+  // Rerun the animation of the current state next time in Character::update(),
+  // so that the new equipment is animated (or baked) right away.
+  _currentState = State::FORCE_UPDATE;
 }
 
 void Character::unequip(Equipment::Type equipmentType) {
   // If there's an equipped item in the target slot,
   // move it into character's inventory.
   if (_equipmentSlots[equipmentType]) {
-    Equipment* e = _equipmentSlots[equipmentType];
+    const Equipment* e = _equipmentSlots[equipmentType];
     _equipmentSlots[equipmentType] = nullptr;
+    _equipmentVersion++;
     addItem(e, 1);
 
-    GameMapManager::getInstance()->getLayer()->removeChild(_equipmentSpritesheets[equipmentType]);
+    _characterNode->removeChild(_equipmentSpritesheets[equipmentType]);
+    GameMapManager::getInstance()->getAnimator()->setLayer(_animatorHandle, getEquipmentAnimatorLayer(equipmentType), nullptr);
+    _equipmentSprites[equipmentType] = nullptr;
+    bakeEquipmentAnimations();
+    _currentState = State::FORCE_UPDATE;
 
     if (equipmentType == Equipment::Type::WEAPON) {
       sheathWeapon();
@@ -757,12 +864,14 @@ void Character::unequip(Equipment::Type equipmentType) {
   }
 }
 
-void Character::pickupItem(Item* item) {
-  item->removeFromMap();
-  addItem(item, item->getAmount());
+void Character::pickupItem(WorldItem* worldItem) {
+  worldItem->removeFromMap();
+  addItem(worldItem->getItem(), worldItem->getAmount());
+  // From now on, these items are only a stack in this character's inventory.
+  delete worldItem;
 }
 
-void Character::discardItem(Item* item, int amount) {
+void Character::discardItem(const Item* item, int amount) {
   const string& jsonFileName = item->getItemProfile().jsonFileName;
   float x = _body->GetPosition().x;
   float y = _body->GetPosition().y;
@@ -884,11 +993,6 @@ void Character::setAlerted(bool alerted) {
 }
 
 
-set<Item*>& Character::getInRangeItems() {
-  return _inRangeItems;
-}
-
-
 const Character::Inventory& Character::getInventory() const {
   return _inventory;
 }
@@ -897,22 +1001,38 @@ const Character::EquipmentSlots& Character::getEquipmentSlots() const {
   return _equipmentSlots;
 }
 
-int Character::getItemAmount(const string& itemName) const {
-  if (_itemMapper.find(itemName) == _itemMapper.end()) {
-    return 0;
+const Character::ItemStack* Character::getItemStack(const Item* item) const {
+  int index = getItemStackIndex(item);
+  return (index != -1) ? &_inventory[item->getItemProfile().itemType][index] : nullptr;
+}
+
+int Character::getItemAmount(Atom itemName) const {
+  // If no such item has been loaded, then nobody has it.
+  const Item* item = Item::getPrototypeByName(itemName);
+  const ItemStack* itemStack = (item) ? getItemStack(item) : nullptr;
+  return (itemStack) ? itemStack->amount : 0;
+}
+
+void Character::setItemHotkey(const Item* item, EventKeyboard::KeyCode hotkey) {
+  int index = getItemStackIndex(item);
+  if (index != -1) {
+    _inventory[item->getItemProfile().itemType][index].hotkey = hotkey;
   }
-  return _itemMapper.at(itemName)->getAmount();
 }
 
+uint32_t Character::getInventoryVersion() const {
+  return _inventoryVersion;
+}
 
-Interactable* Character::getInteractableObject() const {
-  return _interactableObject;
+uint32_t Character::getEquipmentVersion() const {
+  return _equipmentVersion;
 }
 
-void Character::setInteractableObject(Interactable* interactableObject) {
-  _interactableObject = interactableObject;
+uint32_t Character::getSkillsVersion() const {
+  return _skillsVersion;
 }
 
+
 GameMap::Portal* Character::getPortal() const {
   return _portal;
 }
@@ -922,7 +1042,12 @@ void Character::setPortal(GameMap::Portal* portal) {
 }
 
 
-vector<Skill*>& Character::getSkills() {
+void Character::addSkill(Skill* skill) {
+  _skills.push_back(skill);
+  _skillsVersion++;
+}
+
+const vector<Skill*>& Character::getSkills() const {
   return _skills;
 }
 
@@ -940,7 +1065,7 @@ void Character::setCategoryBits(b2Fixture* fixture, short bits) {
 int Character::getDamageOutput() const {
   int output = _characterProfile.baseMeleeDamage;
 
-  Equipment* weapon = _equipmentSlots[Equipment::Type::WEAPON];
+  const Equipment* weapon = _equipmentSlots[Equipment::Type::WEAPON];
   if (weapon) {
     output += weapon->getEquipmentProfile().bonusPhysicalDamage;
   }
@@ -973,6 +1098,8 @@ void Character::regenStamina(int deltaStamina) {
   stamina = (stamina > fullStamina) ? fullStamina : stamina;
 }
 
+void Character::onKilled(Character*) {}
+
 
 
 Character::Profile::Profile(const string& jsonFileName) : jsonFileName(jsonFileName) {
@@ -983,6 +1110,7 @@ Character::Profile::Profile(const string& jsonFileName) : jsonFileName(jsonFileN
   spriteOffsetY = json["spriteOffsetY"].GetFloat();
   spriteScaleX = json["spriteScaleX"].GetFloat();
   spriteScaleY = json["spriteScaleY"].GetFloat();
+  bakesEquipmentSprites = json.HasMember("bakesEquipmentSprites") && json["bakesEquipmentSprites"].GetBool();
 
   for (int i = 0; i < Character::State::STATE_SIZE; i++) {
     float interval = json["frameInterval"][Character::_kCharacterStateStr[i].c_str()].GetFloat();
@@ -990,6 +1118,7 @@ Character::Profile::Profile(const string& jsonFileName) : jsonFileName(jsonFileN
   }
 
   name = json["name"].GetString();
+  nameAtom = Atom(name);
   level = json["level"].GetInt();
   exp = json["exp"].GetInt();
 
@@ -1018,4 +1147,9 @@ Character::Profile::Profile(const string& jsonFileName) : jsonFileName(jsonFileN
   baseMeleeDamage = json["baseMeleeDamage"].GetInt();
 }
 
+
+bool Character::ItemStack::operator ==(const Character::ItemStack& other) const {
+  return item == other.item && amount == other.amount && hotkey == other.hotkey;
+}
+
 } // namespace vigilante
@@ -18,8 +18,10 @@
 #include "item/Item.h"
 #include "item/Equipment.h"
 #include "item/Consumable.h"
+#include "item/WorldItem.h"
 #include "map/GameMap.h"
 #include "skill/Skill.h"
+#include "util/Atom.h"
 
 namespace vigilante {
 
@@ -36,8 +38,10 @@ class Character : public DynamicActor, public Importable {
     float spriteScaleX;
     float spriteScaleY;
     std::vector<float> frameInterval;
+    bool bakesEquipmentSprites;
 
     std::string name;
+    Atom nameAtom; // for lookups
     int level;
     int exp;
 
@@ -97,15 +101,21 @@ class Character : public DynamicActor, public Importable {
   virtual void receiveDamage(Character* source, int damage);
   virtual void lockOn(Character* target);
 
-  virtual void addItem(Item* item, int amount=1);
-  virtual void removeItem(Item* item, int amount=1);
-  virtual void useItem(Consumable* consumable);
-  virtual void equip(Equipment* equipment);
+  virtual void addItem(const Item* item, int amount=1);
+  virtual void removeItem(const Item* item, int amount=1);
+  // Same as above, with the item looked up by Item::getPrototype().
+  void addItem(const std::string& itemJsonFileName, int amount=1);
+  void removeItem(const std::string& itemJsonFileName, int amount=1);
+  virtual void useItem(const Consumable* consumable);
+  virtual void equip(const Equipment* equipment);
   virtual void unequip(Equipment::Type equipmentType);
-  virtual void pickupItem(Item* item);
-  virtual void discardItem(Item* item, int amount);
+  virtual void pickupItem(WorldItem* worldItem); // deletes worldItem
+  virtual void discardItem(const Item* item, int amount);
   virtual void interact(Interactable* target);
 
+  // Called after GameMapManager has cleared the CompositeAtlasCache.
+  void rebakeEquipmentAnimations();
+
   bool isFacingRight() const;
   bool isJumping() const;
   bool isDoubleJumping() const;
@@ -136,22 +146,40 @@ class Character : public DynamicActor, public Importable {
   bool isAlerted() const;
   void setAlerted(bool alerted);
 
-  std::set<Item*>& getInRangeItems();
-
-  Interactable* getInteractableObject() const;
-  void setInteractableObject(Interactable* interactableObject);
-
   GameMap::Portal* getPortal() const;
   void setPortal(GameMap::Portal* portal);
 
-  std::vector<Skill*>& getSkills();
+  void addSkill(Skill* skill);
+  const std::vector<Skill*>& getSkills() const;
   Skill* getCurrentlyUsedSkill() const;
 
-  using Inventory = std::array<std::vector<Item*>, Item::Type::SIZE>;
-  using EquipmentSlots = std::array<Equipment*, Equipment::Type::SIZE>;
+  // All the items of the same kind that a character has. Items are shared (see Item.h),
+  // so an inventory is only these stacks, and there's at most one stack per Item.
+  struct ItemStack {
+    bool operator ==(const Character::ItemStack& other) const; // for ListView
+
+    const Item* item;
+    int amount;
+    cocos2d::EventKeyboard::KeyCode hotkey; // consumables only, see HotkeyManager
+  };
+
+  using Inventory = std::array<std::vector<Character::ItemStack>, Item::Type::SIZE>;
+  using EquipmentSlots = std::array<const Equipment*, Equipment::Type::SIZE>;
   const Inventory& getInventory() const;
   const EquipmentSlots& getEquipmentSlots() const;
-  int getItemAmount(const std::string& itemName) const;
+  // Returns nullptr if this character has none of `item`. The stack is only valid
+  // until the inventory changes.
+  const Character::ItemStack* getItemStack(const Item* item) const;
+  int getItemAmount(Atom itemName) const;
+  // Only meant for HotkeyManager, which keeps the bound action itself.
+  void setItemHotkey(const Item* item, cocos2d::EventKeyboard::KeyCode hotkey);
+
+  // These are bumped whenever the corresponding state changes, so that the UI
+  // (e.g., PauseMenu) only rebuilds what has changed. They start at 1,
+  // so 0 can be used as "never seen".
+  uint32_t getInventoryVersion() const;
+  uint32_t getEquipmentVersion() const;
+  uint32_t getSkillsVersion() const;
 
   int getDamageOutput() const;
   
@@ -163,6 +191,8 @@ class Character : public DynamicActor, public Importable {
   virtual void regenHealth(int deltaHealth);
   virtual void regenMagicka(int deltaMagicka);
   virtual void regenStamina(int deltaStamina);
+  // Called once by receiveDamage() when this character is killed by `source`.
+  virtual void onKilled(Character* source);
 
   enum State {
     IDLE_SHEATHED,
@@ -190,11 +220,20 @@ class Character : public DynamicActor, public Importable {
   virtual void defineTexture(const std::string& bodyTextureResDir, float x, float y);
 
   virtual void loadBodyAnimations(const std::string& bodyTextureResDir);
-  virtual void loadEquipmentAnimations(Equipment* equipment);
+  virtual void loadEquipmentAnimations(const Equipment* equipment);
 
+  // Character animations are driven by Animator (see Animator.h).
+  // Layer 0 of this character's track is the body, and the rest are the equipment.
   void runAnimation(Character::State state, bool loop=true) const;
   void runAnimation(Character::State state, const std::function<void ()>& func) const;
-  void runAnimation(const std::string& framesName, float interval);
+  void runAnimation(Character::State state, bool loop, const std::function<void ()>& func) const;
+  void runAnimation(Atom framesName, float interval);
+  static int getEquipmentAnimatorLayer(Equipment::Type type);
+
+  // Bake the body and equipment animations into a composite atlas
+  // if _characterProfile.bakesEquipmentSprites is true.
+  void bakeEquipmentAnimations();
+  void showBakedSprite(bool shown) const;
 
   Character::State getState() const;
 
@@ -234,28 +273,27 @@ class Character : public DynamicActor, public Importable {
   Character* _lockedOnTarget;
   bool _isAlerted;
 
-  // When player are close enough to an items dropped in the world,
-  // their pointers are stored here.
-  std::set<Item*> _inRangeItems;
-
   // Character's inventory and equipment slots.
   // These two types are aliased. See the beginning of this class.
-  // We use an extra std::map to keep track of each item's count.
-  // For each instance of Item, only one copy of Item* is stored.
+  // Equipped items are not in the inventory.
   Character::Inventory _inventory;
   Character::EquipmentSlots _equipmentSlots;
 
-  // For each item, at most one copy of Item* is kept in memory.
-  Item* getExistingItemObj(Item* item) const;
-  std::unordered_map<std::string, Item*> _itemMapper;   
+  // Where each item's stack is in _inventory[itemType], so that looking up,
+  // adding and removing stacks is O(1).
+  int getItemStackIndex(const Item* item) const;
+  std::vector<int> _itemStackIndices; // indexed by Item::getId(), -1 if none
+  uint32_t _inventoryVersion;
+  uint32_t _equipmentVersion;
 
 
-  // The interactable object / portal to which this character is near.
-  Interactable* _interactableObject;
+  // The portal to which this character is near.
+  // (Interactable objects and NPCs are looked up in GameMap's SpatialHash instead)
   GameMap::Portal* _portal;
 
   // Currently used skill.
   std::vector<Skill*> _skills;
+  uint32_t _skillsVersion;
   Skill* _currentlyUsedSkill;
 
   // Extra attack animations.
@@ -267,12 +305,30 @@ class Character : public DynamicActor, public Importable {
   // Besides body sprite and animations (declared in Actor abstract class),
   // there is also a sprite for each equipment slots! Each equipped equipment
   // has their own animation!
+  //
+  // The body spritesheet and equipment spritesheets are children of _characterNode
+  // (the latter sorted by graphical_layers::kEquipment - type), so moving/flipping
+  // _characterNode moves/flips the whole character.
   std::array<cocos2d::Sprite*, Equipment::Type::SIZE> _equipmentSprites;
   std::array<cocos2d::SpriteBatchNode*, Equipment::Type::SIZE> _equipmentSpritesheets;
   std::array<std::array<cocos2d::Animation*, Character::State::STATE_SIZE>, Equipment::Type::SIZE> _equipmentAnimations;
 
   // Skill animations
-  std::unordered_map<std::string, cocos2d::Animation*> _skillBodyAnimations;
+  AtomMap<cocos2d::Animation*> _skillBodyAnimations; // keyed by framesName
+  FlatMap<std::pair<Atom, Atom>, cocos2d::Animation*> _skillEquipmentAnimations; // keyed by (textureResDir, framesName)
+
+  // Baked composite animations (see CompositeAtlasCache.h).
+  // When _hasBakedAnimations is true, the body and all equipment are drawn
+  // as _bakedSprite alone, except for skill animations which aren't baked.
+  cocos2d::Sprite* _bakedSprite;
+  std::array<cocos2d::Animation*, Character::State::STATE_SIZE> _bakedAnimations;
+  std::array<cocos2d::Animation*, 1> _bakedExtraAttackAnimations;
+  bool _hasBakedAnimations;
+
+  // This character's track in GameMapManager's Animator.
+  int _animatorHandle;
+
+  cocos2d::Node* _characterNode;
 };
 
 } // namespace vigilante
@@ -1,6 +1,8 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "Enemy.h"
 
+#include <vector>
+
 #include <json/document.h>
 
 #include "AssetManager.h"
@@ -11,11 +13,11 @@
 #include "map/GameMapManager.h"
 #include "ui/notifications/Notifications.h"
 #include "util/box2d/b2BodyBuilder.h"
-#include "util/CallbackUtil.h"
 #include "util/RandUtil.h"
 #include "util/JsonUtil.h"
 
 using std::string;
+using std::vector;
 using cocos2d::Vector;
 using cocos2d::Director;
 using cocos2d::Repeat;
@@ -34,7 +36,6 @@ using vigilante::category_bits::kMeleeWeapon;
 using vigilante::category_bits::kItem;
 using vigilante::category_bits::kGround;
 using vigilante::category_bits::kPlatform;
-using vigilante::category_bits::kCliffMarker;
 using vigilante::category_bits::kWall;
 using vigilante::category_bits::kInteractableObject;
 using vigilante::category_bits::kProjectile;
@@ -42,6 +43,8 @@ using rapidjson::Document;
 
 namespace vigilante {
 
+const float Enemy::_kSightRange = 2.5f;
+
 Enemy::Enemy(const string& jsonFileName)
     : Character(jsonFileName),
       Bot(this),
@@ -49,7 +52,7 @@ Enemy::Enemy(const string& jsonFileName)
 
 void Enemy::update(float delta) {
   Character::update(delta);
-  act(delta);
+  tick(delta);
 }
 
 void Enemy::showOnMap(float x, float y) {
@@ -61,21 +64,15 @@ void Enemy::showOnMap(float x, float y) {
 
   // Construct b2Body and b2Fixtures.
   short bodyCategoryBits = kEnemy;
-  short bodyMaskBits = kFeet | kPlayer | kMeleeWeapon | kCliffMarker | kProjectile;
-  short feetMaskBits = kGround | kPlatform | kWall | kItem | kInteractableObject;
+  short bodyMaskBits = kFeet | kPlayer | kMeleeWeapon | kProjectile;
+  short feetMaskBits = kGround | kPlatform | kWall;
   short weaponMaskBits = kPlayer;
   defineBody(b2BodyType::b2_dynamicBody, bodyCategoryBits, bodyMaskBits, feetMaskBits, weaponMaskBits, x, y);
 
   // Load sprites, spritesheets, and animations, and then add them to GameMapManager layer.
   defineTexture(_characterProfile.textureResDir, x, y);
   GameMapManager* gmMgr = GameMapManager::getInstance();
-  gmMgr->getLayer()->addChild(_bodySpritesheet, graphical_layers::kEnemyBody);
-  for (auto equipment : _equipmentSlots) {
-    if (equipment) {
-      Equipment::Type type = equipment->getEquipmentProfile().equipmentType;
-      gmMgr->getLayer()->addChild(_equipmentSpritesheets[type], graphical_layers::kEquipment - type);
-    }
-  }
+  gmMgr->getLayer()->addChild(_characterNode, graphical_layers::kEnemyBody);
 }
 
 void Enemy::import(const string& jsonFileName) {
@@ -84,41 +81,61 @@ void Enemy::import(const string& jsonFileName) {
 }
 
 
+void Enemy::perceive() {
+  // Notice the player only if it can be seen through open space.
+  if (!_isAlerted && !_isSetToKill) {
+    GameMap* gameMap = GameMapManager::getInstance()->getGameMap();
+    const b2Vec2& pos = _body->GetPosition();
+
+    for (auto c : gameMap->getSpatialHash().charactersInRange(pos, _kSightRange, kPlayer)) {
+      if (!c->isSetToKill() && gameMap->getOccupancyGrid().hasLineOfSight(pos, c->getBody()->GetPosition())) {
+        lockOn(c);
+        break;
+      }
+    }
+  }
+}
+
 void Enemy::receiveDamage(Character* source, int damage) {
   Character::receiveDamage(source, damage);
   _isAlerted = true;
+}
 
-  if (_isSetToKill) {
-    // Give source character exp point.
-    int& sourceCharacterExp = source->getCharacterProfile().exp;
-    int& sourceCharacterLevel = source->getCharacterProfile().level;
+void Enemy::onKilled(Character* source) {
+  // Give source character exp point.
+  int& sourceCharacterExp = source->getCharacterProfile().exp;
+  int& sourceCharacterLevel = source->getCharacterProfile().level;
 
-    sourceCharacterExp += getCharacterProfile().exp;
-    Notifications::getInstance()->show("Acquired " + std::to_string(getCharacterProfile().exp) + " exp.");
+  sourceCharacterExp += getCharacterProfile().exp;
+  Notifications::getInstance()->show("Acquired " + std::to_string(getCharacterProfile().exp) + " exp.");
 
-    while (sourceCharacterExp >= exp_point_table::getNextLevelExp(sourceCharacterLevel)) {
-      sourceCharacterExp -= exp_point_table::getNextLevelExp(sourceCharacterLevel);
-      sourceCharacterLevel++;
-      Notifications::getInstance()->show("Congratulations! You are now level " + std::to_string(sourceCharacterLevel) + ".");
-    }
+  while (sourceCharacterExp >= exp_point_table::getNextLevelExp(sourceCharacterLevel)) {
+    sourceCharacterExp -= exp_point_table::getNextLevelExp(sourceCharacterLevel);
+    sourceCharacterLevel++;
+    Notifications::getInstance()->show("Congratulations! You are now level " + std::to_string(sourceCharacterLevel) + ".");
+  }
 
-    // Drop items. (Here we'll use a callback to drop items
-    // since creating fixtures during collision callback will crash)
-    // See: https://github.com/libgdx/libgdx/issues/2730
-    callback_util::runAfter([=]() {
-      for (const auto& i : _enemyProfile.droppedItems) {
-        const string& itemJson = i.first;
-        float dropChance = i.second.chance;
-
-        float randChance = rand_util::randInt(0, 100);
-        if (randChance <= dropChance) {
-          float x = _body->GetPosition().x;
-          float y = _body->GetPosition().y;
-          int amount = rand_util::randInt(i.second.minAmount, i.second.maxAmount);
-          GameMapManager::getInstance()->getGameMap()->spawnItem(itemJson, x * kPpm, y * kPpm, amount);
-        }
-      }
-    }, .2f);
+  // Drop items. Creating fixtures during collision callback will crash,
+  // so the item bodies are spawned via WorldCommandBuffer after b2World::Step().
+  // See: https://github.com/libgdx/libgdx/issues/2730
+  float x = _body->GetPosition().x;
+  float y = _body->GetPosition().y;
+  WorldCommandBuffer* cmdBuffer = GameMapManager::getInstance()->getWorldCommandBuffer();
+
+  // Roll the drop chances of all items at once.
+  Rng& rng = rand_util::getStream(rand_util::Stream::LOOT);
+  vector<int> randChances(_enemyProfile.droppedItems.size());
+  rng.randInts(0, 100, randChances.data(), randChances.size());
+
+  size_t idx = 0;
+  for (const auto& i : _enemyProfile.droppedItems) {
+    const string& itemJson = i.first;
+    int dropChance = i.second.chance;
+
+    if (randChances[idx++] <= dropChance) {
+      int amount = rng.randInt(i.second.minAmount, i.second.maxAmount);
+      cmdBuffer->spawnItem(itemJson, x * kPpm, y * kPpm, amount);
+    }
   }
 }
 
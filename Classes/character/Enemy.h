@@ -37,7 +37,14 @@ class Enemy : public Character, public Bot {
 
   Enemy::Profile& getEnemyProfile();
   
+ protected:
+  virtual void onKilled(Character* source) override; // Character
+  virtual void perceive() override; // Bot
+
  private:
+  // The player is noticed within this range if it's in the line of sight.
+  static const float _kSightRange;
+
   Enemy::Profile _enemyProfile;
 };
 
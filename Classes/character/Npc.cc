@@ -1,13 +1,15 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "Npc.h"
 
+#include <algorithm>
+
 #include <json/document.h>
 #include "AssetManager.h"
 #include "Constants.h"
+#include "character/Player.h"
 #include "item/Item.h"
 #include "map/GameMapManager.h"
 #include "ui/dialogue/DialogueManager.h"
-#include "util/box2d/b2BodyBuilder.h"
 #include "util/CallbackUtil.h"
 #include "util/RandUtil.h"
 #include "util/JsonUtil.h"
@@ -28,12 +30,10 @@ using cocos2d::SpriteBatchNode;
 using vigilante::category_bits::kPlayer;
 using vigilante::category_bits::kEnemy;
 using vigilante::category_bits::kNpc;
-using vigilante::category_bits::kFeet;
 using vigilante::category_bits::kMeleeWeapon;
 using vigilante::category_bits::kItem;
 using vigilante::category_bits::kGround;
 using vigilante::category_bits::kPlatform;
-using vigilante::category_bits::kCliffMarker;
 using vigilante::category_bits::kWall;
 using vigilante::category_bits::kPortal;
 using vigilante::category_bits::kInteractableObject;
@@ -46,7 +46,8 @@ Npc::Npc(const string& jsonFileName)
     : Character(jsonFileName),
       Bot(this),
       _npcProfile(jsonFileName),
-      _dialogueTree(_npcProfile.dialogueTree) {}
+      _dialogueTree(&DialogueTree::getDialogueTree(_npcProfile.dialogueTree)),
+      _currentDialogueIdx() {}
 
 void Npc::update(float delta) {
   Character::update(delta);
@@ -62,53 +63,22 @@ void Npc::showOnMap(float x, float y) {
 
   // Construct b2Body and b2Fixtures.
   short bodyCategoryBits = kNpc;
-  short bodyMaskBits = kFeet | kMeleeWeapon | kCliffMarker | kProjectile;
-  short feetMaskBits = kGround | kPlatform | kWall | kItem | kPortal | kInteractableObject;
+  short bodyMaskBits = kMeleeWeapon | kProjectile;
+  short feetMaskBits = kGround | kPlatform | kWall | kPortal;
   short weaponMaskBits = kPlayer | kEnemy | kNpc;
   defineBody(b2BodyType::b2_dynamicBody, bodyCategoryBits, bodyMaskBits, feetMaskBits, weaponMaskBits, x, y);
 
   // Load sprites, spritesheets, and animations, and then add them to GameMapManager layer.
   defineTexture(_characterProfile.textureResDir, x, y);
   GameMapManager* gmMgr = GameMapManager::getInstance();
-  gmMgr->getLayer()->addChild(_bodySpritesheet, graphical_layers::kNpcBody);
-  for (auto equipment : _equipmentSlots) {
-    if (equipment) {
-      Equipment::Type type = equipment->getEquipmentProfile().equipmentType;
-      gmMgr->getLayer()->addChild(_equipmentSpritesheets[type], graphical_layers::kEquipment - type);
-    }
-  }
-}
-
-void Npc::defineBody(b2BodyType bodyType, short bodyCategoryBits, short bodyMaskBits,
-                     short feetMaskBits, short weaponMaskBits, float x, float y) {
-  Character::defineBody(bodyType, bodyCategoryBits, bodyMaskBits, feetMaskBits, weaponMaskBits, x, y);
-
-  // Besides the original fixtures created in Character::defineBody(),
-  // create one extra fixture which can collide with player's feetFixture,
-  // but make it a sensor.
-  b2BodyBuilder bodyBuilder(_body);
-
-  // Create body fixture.
-  // Fixture position in box2d is relative to b2body's position.
-  float scaleFactor = Director::getInstance()->getContentScaleFactor();
-  b2Vec2 vertices[4];
-  float sideLength = std::max(_characterProfile.bodyWidth, _characterProfile.bodyHeight) * 1.5;
-  vertices[0] = {-sideLength / scaleFactor,  sideLength / scaleFactor};
-  vertices[1] = { sideLength / scaleFactor,  sideLength / scaleFactor};
-  vertices[2] = {-sideLength / scaleFactor, -sideLength / scaleFactor};
-  vertices[3] = { sideLength / scaleFactor, -sideLength / scaleFactor};
-
-  bodyBuilder.newPolygonFixture(vertices, 4, kPpm)
-    .categoryBits(bodyCategoryBits)
-    .maskBits(bodyMaskBits | kFeet)
-    .setSensor(true)
-    .setUserData(this)
-    .buildFixture();
+  gmMgr->getLayer()->addChild(_characterNode, graphical_layers::kNpcBody);
 }
 
 void Npc::import(const string& jsonFileName) {
   Character::import(jsonFileName);
   _npcProfile = Npc::Profile(jsonFileName);
+  _dialogueTree = &DialogueTree::getDialogueTree(_npcProfile.dialogueTree);
+  _currentDialogueIdx = 0;
 }
 
 
@@ -120,23 +90,46 @@ void Npc::receiveDamage(Character* source, int damage) {
 void Npc::onInteract(Character* user) {
   auto dialogueMgr = DialogueManager::getInstance();
   dialogueMgr->setTargetNpc(this);
-  for (const auto& line : _dialogueTree.getCurrentNode()->lines) {
+  for (const auto& line : getCurrentDialogue()->lines) {
     dialogueMgr->getSubtitles()->addSubtitle(line);
   }
   dialogueMgr->getSubtitles()->beginSubtitles();
+
+  Player* player = GameMapManager::getInstance()->getPlayer();
+  if (user == player) {
+    player->getQuestBook().update(Quest::Objective::Type::TALK_TO, _characterProfile.nameAtom);
+  }
 }
 
 bool Npc::willInteractOnContact() const {
   return false;
 }
 
+float Npc::getInteractionRange() const {
+  // 1.5x the larger side of its body.
+  float scaleFactor = Director::getInstance()->getContentScaleFactor();
+  return std::max(_characterProfile.bodyWidth, _characterProfile.bodyHeight) * 1.5f / scaleFactor / kPpm;
+}
+
 
 Npc::Profile& Npc::getNpcProfile() {
   return _npcProfile;
 }
 
-DialogueTree& Npc::getDialogueTree() {
-  return _dialogueTree;
+const DialogueTree& Npc::getDialogueTree() const {
+  return *_dialogueTree;
+}
+
+const Dialogue* Npc::getCurrentDialogue() const {
+  return _dialogueTree->getNode(_currentDialogueIdx);
+}
+
+void Npc::setCurrentDialogue(const Dialogue* dialogue) {
+  _currentDialogueIdx = _dialogueTree->getNodeIdx(dialogue);
+}
+
+void Npc::resetCurrentDialogue() {
+  _currentDialogueIdx = 0; // root node
 }
 
 
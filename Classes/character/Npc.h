@@ -30,16 +30,18 @@ class Npc : public Character, public Bot, public Interactable {
 
   virtual void onInteract(Character* user) override; // Interactable
   virtual bool willInteractOnContact() const override; // Interactable
+  virtual float getInteractionRange() const override; // Interactable
 
   Npc::Profile& getNpcProfile();
-  DialogueTree& getDialogueTree();
+  const DialogueTree& getDialogueTree() const;
+  const Dialogue* getCurrentDialogue() const;
+  void setCurrentDialogue(const Dialogue* dialogue);
+  void resetCurrentDialogue();
   
  private:
-  void defineBody(b2BodyType bodyType, short bodyCategoryBits, short bodyMaskBits,
-                  short feetMaskBits, short weaponMaskBits, float x, float y) override;
-
   Npc::Profile _npcProfile;
-  DialogueTree _dialogueTree;
+  const DialogueTree* _dialogueTree; // shared with other npcs
+  int _currentDialogueIdx;
 };
 
 } // namespace vigilante
@@ -14,7 +14,6 @@
 #include "skill/BackDash.h"
 #include "skill/ForwardSlash.h"
 #include "skill/MagicalMissile.h"
-#include "quest/KillTargetObjective.h"
 #include "ui/Shade.h"
 #include "ui/hud/Hud.h"
 #include "ui/notifications/Notifications.h"
@@ -66,20 +65,14 @@ void Player::showOnMap(float x, float y) {
   // Construct b2Body and b2Fixtures
   short bodyCategoryBits = kPlayer;
   short bodyMaskBits = kFeet | kEnemy | kMeleeWeapon | kProjectile;
-  short feetMaskBits = kGround | kPlatform | kWall | kItem | kNpc | kPortal | kInteractableObject;
+  short feetMaskBits = kGround | kPlatform | kWall | kPortal;
   short weaponMaskBits = kEnemy;
   defineBody(b2BodyType::b2_dynamicBody, bodyCategoryBits, bodyMaskBits, feetMaskBits, weaponMaskBits, x, y);
 
   // Load sprites, spritesheets, and animations, and then add them to GameMapManager layer.
   defineTexture(_characterProfile.textureResDir, x, y);
   GameMapManager* gmMgr = GameMapManager::getInstance();
-  gmMgr->getLayer()->addChild(_bodySpritesheet, graphical_layers::kPlayerBody);
-  for (auto equipment : _equipmentSlots) {
-    if (equipment) {
-      Equipment::Type type = equipment->getEquipmentProfile().equipmentType;
-      gmMgr->getLayer()->addChild(_equipmentSpritesheets[type], graphical_layers::kEquipment - type);
-    }
-  }
+  gmMgr->getLayer()->addChild(_characterNode, graphical_layers::kPlayerBody);
 }
 
 void Player::removeFromMap() {
@@ -94,13 +87,14 @@ void Player::removeFromMap() {
   }
 
   GameMapManager* gmMgr = GameMapManager::getInstance();
-  gmMgr->getLayer()->removeChild(_bodySpritesheet);
-  for (auto equipment : _equipmentSlots) {
-    if (equipment) {
-      Equipment::Type type = equipment->getEquipmentProfile().equipmentType;
-      gmMgr->getLayer()->removeChild(_equipmentSpritesheets[type]);
-    }
-  }
+  gmMgr->getAnimator()->remove(_animatorHandle);
+  _animatorHandle = Animator::_kInvalidHandle;
+  gmMgr->getGameMap()->getSpatialHash().remove(this);
+
+  gmMgr->getLayer()->removeChild(_characterNode);
+  _characterNode->removeChild(_bodySpritesheet);
+  _characterNode->removeChild(_bakedSprite);
+  _bakedSprite = nullptr;
 }
 
 
@@ -112,8 +106,13 @@ void Player::handleInput() {
   auto inputMgr = InputManager::getInstance();
 
   if (inputMgr->isKeyJustPressed(EventKeyboard::KeyCode::KEY_E)) {
-    if (_interactableObject) {
-      interact(_interactableObject);
+    // Like the sensors these used to have, they're reached with the feet.
+    b2AABB feetAABB;
+    _fixtures[FixtureType::FEET]->GetShape()->ComputeAABB(&feetAABB, _body->GetTransform(), 0);
+    SpatialHash& spatialHash = GameMapManager::getInstance()->getGameMap()->getSpatialHash();
+    Interactable* interactableObject = spatialHash.nearestInteractable(feetAABB);
+    if (interactableObject) {
+      interact(interactableObject);
     }
     return;
   } else if (inputMgr->isKeyJustPressed(EventKeyboard::KeyCode::KEY_UP_ARROW)) {
@@ -130,7 +129,9 @@ void Player::handleInput() {
     }
   }
 
-  if (inputMgr->isKeyJustPressed(EventKeyboard::KeyCode::KEY_LEFT_CTRL)) {
+  // Attacks and skills are buffered, so that they can be chained
+  // by pressing the key again before the current one is over.
+  if (inputMgr->consumeKeyPress(EventKeyboard::KeyCode::KEY_LEFT_CTRL)) {
     if (!_isWeaponSheathed) {
       attack();
     }
@@ -152,23 +153,41 @@ void Player::handleInput() {
   }
 
   // Hotkeys
-  for (auto keyCode : HotkeyManager::_kBindableKeys) {
-    Keybindable* action = HotkeyManager::getInstance()->getHotkeyAction(keyCode);
-    if (inputMgr->isKeyJustPressed(keyCode) && action) {
-      if (dynamic_cast<Skill*>(action)) {
-        activateSkill(dynamic_cast<Skill*>(action));
-      } else if (dynamic_cast<Consumable*>(action)) {
-        useItem(dynamic_cast<Consumable*>(action));
-      }
+  HotkeyManager* hotkeyMgr = HotkeyManager::getInstance();
+  for (int i = 0; i < HotkeyManager::BindableKeys::SIZE; i++) {
+    const HotkeyManager::Action& action = hotkeyMgr->getAction(static_cast<HotkeyManager::BindableKeys>(i));
+    if (action.type == HotkeyManager::Action::Type::NONE
+        || !inputMgr->consumeKeyPress(HotkeyManager::_kBindableKeys[i])) {
+      continue;
+    }
+
+    switch (action.type) {
+      case HotkeyManager::Action::Type::SKILL:
+        activateSkill(action.skill);
+        break;
+      case HotkeyManager::Action::Type::CONSUMABLE:
+        useItem(action.consumable);
+        break;
+      default:
+        break;
     }
   }
 
   if (inputMgr->isKeyJustPressed(EventKeyboard::KeyCode::KEY_Z)) {
-    if (!_inRangeItems.empty()) {
-      Item* item = *_inRangeItems.begin();
-      string itemName = item->getItemProfile().name;
-      int amount = item->getAmount();
-      pickupItem(item);
+    // Pick up the items under this player's feet.
+    float scaleFactor = Director::getInstance()->getContentScaleFactor();
+    float bw = _characterProfile.bodyWidth / scaleFactor / kPpm;
+    float bh = _characterProfile.bodyHeight / scaleFactor / kPpm;
+    b2AABB feetAABB;
+    feetAABB.lowerBound = {_body->GetPosition().x - bw / 2, _body->GetPosition().y - bh / 2 - kIconSize / kPpm};
+    feetAABB.upperBound = {_body->GetPosition().x + bw / 2, _body->GetPosition().y};
+
+    vector<WorldItem*> items = GameMapManager::getInstance()->getGameMap()->getSpatialHash().itemsUnder(feetAABB);
+    if (!items.empty()) {
+      WorldItem* worldItem = items.front();
+      string itemName = worldItem->getItem()->getName();
+      int amount = worldItem->getAmount();
+      pickupItem(worldItem);
       Notifications::getInstance()->show("Acquired item: " + itemName + ((amount > 1) ? (" (" + std::to_string(amount) + ")" + ".") : ""));
     }
   }
@@ -184,15 +203,15 @@ void Player::handleInput() {
 
 
 void Player::inflictDamage(Character* target, int damage) {
+  if (target->isSetToKill()) {
+    return;
+  }
+
   Character::inflictDamage(target, damage);
   camera_util::shake(8, .1f);
 
   if (target->isSetToKill()) {
-    const string& targetName = target->getCharacterProfile().name;
-    for (const auto objective : KillTargetObjective::getRelatedObjectives(targetName)) {
-      dynamic_cast<KillTargetObjective*>(objective)->incrementCurrentAmount();
-    }
-    _questBook.update(Quest::Objective::Type::KILL);
+    _questBook.update(Quest::Objective::Type::KILL, target->getCharacterProfile().nameAtom);
   }
 }
 
@@ -208,10 +227,9 @@ void Player::receiveDamage(Character* source, int damage) {
     _isInvincible = false;
   }, 1.5f);
 
-  Hud::getInstance()->updateStatusBars();
 }
 
-void Player::equip(Equipment* equipment) {
+void Player::equip(const Equipment* equipment) {
   Character::equip(equipment);
   Hud::getInstance()->updateEquippedWeapon();
 }
@@ -221,9 +239,19 @@ void Player::unequip(Equipment::Type equipmentType) {
   Hud::getInstance()->updateEquippedWeapon();
 }
 
-void Player::pickupItem(Item* item) {
-  Character::pickupItem(item);
-  _questBook.update(Quest::Objective::Type::COLLECT);
+void Player::addItem(const Item* item, int amount) {
+  if (!item) {
+    return;
+  }
+  Atom itemName = item->getItemProfile().nameAtom;
+  Character::addItem(item, amount);
+  _questBook.update(Quest::Objective::Type::COLLECT, itemName, getItemAmount(itemName));
+}
+
+void Player::removeItem(const Item* item, int amount) {
+  Atom itemName = item->getItemProfile().nameAtom;
+  Character::removeItem(item, amount);
+  _questBook.update(Quest::Objective::Type::COLLECT, itemName, getItemAmount(itemName));
 }
 
 
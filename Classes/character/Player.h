@@ -24,9 +24,12 @@ class Player : public Character, public Controllable {
   virtual void inflictDamage(Character* target, int damage) override; // Character
   virtual void receiveDamage(Character* source, int damage) override; // Character
 
-  virtual void equip(Equipment* equipment) override; // Character
+  virtual void equip(const Equipment* equipment) override; // Character
   virtual void unequip(Equipment::Type equipmentType) override; // Character
-  virtual void pickupItem(Item* item) override; // Character
+  virtual void addItem(const Item* item, int amount=1) override; // Character
+  virtual void removeItem(const Item* item, int amount=1) override; // Character
+  using Character::addItem;
+  using Character::removeItem;
 
   QuestBook& getQuestBook();
 
@@ -0,0 +1,82 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "AutoSave.h"
+
+#include "util/Logger.h"
+
+using std::mutex;
+using std::unique_ptr;
+using std::unique_lock;
+using std::lock_guard;
+
+namespace vigilante {
+
+AutoSave* AutoSave::_instance = nullptr;
+
+AutoSave* AutoSave::getInstance() {
+  if (!_instance) {
+    _instance = new AutoSave();
+  }
+  return _instance;
+}
+
+AutoSave::AutoSave()
+    : _writer(),
+      _mutex(),
+      _pendingCv(),
+      _idleCv(),
+      _pendingSnapshot(),
+      _isWriting(),
+      _isShuttingDown() {
+  _writer = std::thread(&AutoSave::runWriter, this);
+}
+
+AutoSave::~AutoSave() {
+  {
+    lock_guard<mutex> lock(_mutex);
+    _isShuttingDown = true;
+  }
+  _pendingCv.notify_one();
+  _writer.join();
+}
+
+
+void AutoSave::save() {
+  unique_ptr<SaveGame::Snapshot> snapshot(new SaveGame::Snapshot(SaveGame::capture()));
+  {
+    lock_guard<mutex> lock(_mutex);
+    _pendingSnapshot = std::move(snapshot);
+  }
+  _pendingCv.notify_one();
+}
+
+void AutoSave::flush() {
+  unique_lock<mutex> lock(_mutex);
+  _idleCv.wait(lock, [this]() { return !_pendingSnapshot && !_isWriting; });
+}
+
+
+void AutoSave::runWriter() {
+  unique_lock<mutex> lock(_mutex);
+
+  while (true) {
+    _pendingCv.wait(lock, [this]() { return _pendingSnapshot || _isShuttingDown; });
+    // Write out the last snapshot before shutting down.
+    if (!_pendingSnapshot) {
+      break;
+    }
+
+    unique_ptr<SaveGame::Snapshot> snapshot = std::move(_pendingSnapshot);
+    _isWriting = true;
+    lock.unlock();
+
+    if (!SaveGame(SaveGame::getDefaultSaveFileName()).save(*snapshot)) {
+      VGLOG(LOG_ERR, "Autosave failed");
+    }
+
+    lock.lock();
+    _isWriting = false;
+    _idleCv.notify_all();
+  }
+}
+
+} // namespace vigilante
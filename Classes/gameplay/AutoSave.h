@@ -0,0 +1,49 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_AUTO_SAVE_H_
+#define VIGILANTE_AUTO_SAVE_H_
+
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "gameplay/SaveGame.h"
+
+namespace vigilante {
+
+// AutoSave writes the default save file on a background thread.
+//
+// save() only copies the game state (SaveGame::capture()) on the main thread
+// and hands the snapshot over to the writer thread, which serializes,
+// compresses and fsyncs it, so autosaving never hitches the game.
+// If another save() comes in before the writer picks up the previous
+// snapshot, the older one is dropped and only the latest one is written.
+class AutoSave {
+ public:
+  static AutoSave* getInstance();
+  virtual ~AutoSave();
+
+  // Must be called on the main thread.
+  void save();
+  // Blocks until all pending snapshots have been written.
+  void flush();
+
+ private:
+  AutoSave();
+  void runWriter();
+
+  static AutoSave* _instance;
+
+  std::thread _writer;
+  std::mutex _mutex;
+  std::condition_variable _pendingCv;
+  std::condition_variable _idleCv;
+
+  std::unique_ptr<SaveGame::Snapshot> _pendingSnapshot;
+  bool _isWriting;
+  bool _isShuttingDown;
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_AUTO_SAVE_H_
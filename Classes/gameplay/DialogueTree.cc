@@ -1,38 +1,42 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "DialogueTree.h"
 
-#include <stack>
+#include <stdexcept>
 
 #include <cocos2d.h>
 #include "util/JsonUtil.h"
 #include "util/Logger.h"
 
-using std::pair;
-using std::stack;
 using std::string;
 using std::vector;
+using std::unique_ptr;
+using std::runtime_error;
 using rapidjson::Document;
 
 namespace vigilante {
 
-DialogueTree::DialogueTree(const string& jsonFileName)
-    : _rootNode(), _currentNode() {
-  import(jsonFileName);
-}
+namespace {
 
-DialogueTree::~DialogueTree() {
-  dfsDeleteNodes(_rootNode);
+template <typename T>
+DialogueTree::Range<T> makeRange(const vector<T>& v, size_t begin, size_t end) {
+  return {v.data() + begin, v.data() + end};
 }
 
-void DialogueTree::dfsDeleteNodes(DialogueTree::Node* node) const {
-  if (!node) {
-    return;
-  }
-  
-  for (auto child : node->children) {
-    dfsDeleteNodes(child);
+} // namespace
+
+AtomMap<unique_ptr<DialogueTree>> DialogueTree::_dialogueTrees;
+
+const DialogueTree& DialogueTree::getDialogueTree(const string& jsonFileName) {
+  unique_ptr<DialogueTree>& dialogueTree = _dialogueTrees[Atom(jsonFileName)];
+  if (!dialogueTree) {
+    dialogueTree = unique_ptr<DialogueTree>(new DialogueTree(jsonFileName));
   }
-  delete node;
+  return *dialogueTree;
+}
+
+DialogueTree::DialogueTree(const string& jsonFileName)
+    : _nodes(), _lines(), _cmds(), _stringPool() {
+  import(jsonFileName);
 }
 
 
@@ -40,57 +44,74 @@ void DialogueTree::import(const string& jsonFileName) {
   VGLOG(LOG_INFO, "Loading dialogue tree...");
   Document json = json_util::parseJson(jsonFileName);
 
-  // Deserialize json into runtime DialogueTree using tree DFS.
-  // DFS 大師 !!!!!!! XDDDDDDDDD
-  stack<pair<rapidjson::Value::Object, Node*>> st; // <jsonObject, parent>
-  st.push({json.GetObject(), nullptr});
-
-  while (!st.empty()) {
-    rapidjson::Value::Object node = st.top().first;
-    Node* parent = st.top().second;
-    st.pop();
-
-    // Construct this node.
-    _currentNode = new Node();
+  // Deserialize json into the flat node array using tree BFS,
+  // so that the children of each node are placed next to each other.
+  // The ranges are recorded as indices first, and turned into pointers
+  // once all the arrays have stopped growing.
+  struct NodeIndices {
+    size_t linesBegin, linesEnd;
+    size_t cmdsBegin, cmdsEnd;
+    size_t childrenBegin, childrenEnd;
+  };
+  vector<const rapidjson::Value*> queue = {&json};
+  vector<NodeIndices> indices;
+  vector<size_t> lineOffsets;
+
+  for (size_t i = 0; i < queue.size(); i++) {
+    const rapidjson::Value& node = *queue[i];
+    NodeIndices idx;
+
+    idx.linesBegin = lineOffsets.size();
     for (const auto& line : node["lines"].GetArray()) {
-      _currentNode->lines.push_back(line.GetString());
+      lineOffsets.push_back(_stringPool.size());
+      _stringPool.append(line.GetString(), line.GetStringLength());
+      _stringPool.push_back('\0');
     }
+    idx.linesEnd = lineOffsets.size();
+
+    idx.cmdsBegin = _cmds.size();
     for (const auto& cmd : node["exec"].GetArray()) {
-      _currentNode->cmds.push_back(cmd.GetString());
+      try {
+        _cmds.push_back(CommandParser::compile(cmd.GetString()));
+      } catch (const runtime_error& ex) {
+        throw runtime_error(jsonFileName + ": " + ex.what());
+      }
     }
+    idx.cmdsEnd = _cmds.size();
 
-    if (!_rootNode) {
-      _rootNode = _currentNode;
-    }
-    if (parent) {
-      parent->children.push_back(_currentNode);
-    }
-   
-    // Push this node's children onto the stack in reverse order.
-    const auto& children = node["children"].GetArray();
-    for (int i = children.Size() - 1; i >= 0; i--) {
-      st.push({children[i].GetObject(), _currentNode});
+    idx.childrenBegin = queue.size();
+    for (const auto& child : node["children"].GetArray()) {
+      queue.push_back(&child);
     }
+    idx.childrenEnd = queue.size();
+
+    indices.push_back(idx);
   }
 
-  // Set _currentNode to _rootNode for later use (UI)
-  _currentNode = _rootNode;
-}
+  _lines.reserve(lineOffsets.size());
+  for (auto offset : lineOffsets) {
+    _lines.push_back(_stringPool.c_str() + offset);
+  }
 
-DialogueTree::Node* DialogueTree::getRootNode() const {
-  return _rootNode;
+  _nodes.resize(indices.size());
+  for (size_t i = 0; i < indices.size(); i++) {
+    const NodeIndices& idx = indices[i];
+    _nodes[i].lines = makeRange(_lines, idx.linesBegin, idx.linesEnd);
+    _nodes[i].cmds = makeRange(_cmds, idx.cmdsBegin, idx.cmdsEnd);
+    _nodes[i].children = makeRange(_nodes, idx.childrenBegin, idx.childrenEnd);
+  }
 }
 
-DialogueTree::Node* DialogueTree::getCurrentNode() const {
-  return _currentNode;
+const DialogueTree::Node* DialogueTree::getRootNode() const {
+  return &_nodes.front();
 }
 
-void DialogueTree::setCurrentNode(DialogueTree::Node* node) {
-  _currentNode = node;
+const DialogueTree::Node* DialogueTree::getNode(int nodeIdx) const {
+  return &_nodes[nodeIdx];
 }
 
-void DialogueTree::resetCurrentNode() {
-  _currentNode = _rootNode;
+int DialogueTree::getNodeIdx(const DialogueTree::Node* node) const {
+  return node - _nodes.data();
 }
 
 } // namespace vigilante
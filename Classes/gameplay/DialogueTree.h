@@ -2,36 +2,61 @@
 #ifndef VIGILANTE_DIALOGUE_TREE_H_
 #define VIGILANTE_DIALOGUE_TREE_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "Importable.h"
+#include "ui/console/CommandParser.h"
+#include "util/Atom.h"
 
 namespace vigilante {
 
+// A DialogueTree is parsed once per json file and shared (read-only)
+// by all the Npcs which use it. Each Npc only keeps the index of its
+// current node, see Npc::getCurrentDialogue().
+//
+// The nodes are stored in a flat array in BFS order, so the children of
+// a node are contiguous. Lines are NUL-terminated strings in one pooled block.
 class DialogueTree : public Importable {
  public:
-  explicit DialogueTree(const std::string& jsonFileName);
-  virtual ~DialogueTree();
+  // A view into one of the tree's arrays.
+  template <typename T>
+  struct Range {
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+    const T& front() const { return *first; }
+    const T& operator[](size_t i) const { return first[i]; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
 
-  virtual void import(const std::string& jsonFileName) override;
+    const T* first;
+    const T* last;
+  };
 
   struct Node {
-    std::vector<std::string> lines;
-    std::vector<std::string> cmds;
-    std::vector<Node*> children;
+    DialogueTree::Range<const char*> lines;
+    DialogueTree::Range<CommandParser::Command> cmds; // compiled at import
+    DialogueTree::Range<DialogueTree::Node> children;
   };
- 
-  DialogueTree::Node* getRootNode() const;
-  DialogueTree::Node* getCurrentNode() const;
-  void setCurrentNode(DialogueTree::Node* node);
-  void resetCurrentNode();
+
+  static const DialogueTree& getDialogueTree(const std::string& jsonFileName);
+  virtual ~DialogueTree() = default;
+
+  const DialogueTree::Node* getRootNode() const;
+  const DialogueTree::Node* getNode(int nodeIdx) const;
+  int getNodeIdx(const DialogueTree::Node* node) const;
 
  private:
-  void dfsDeleteNodes(DialogueTree::Node* node) const;
+  explicit DialogueTree(const std::string& jsonFileName);
+  virtual void import(const std::string& jsonFileName) override;
+
+  static AtomMap<std::unique_ptr<DialogueTree>> _dialogueTrees; // keyed by jsonFileName
 
-  DialogueTree::Node* _rootNode;
-  DialogueTree::Node* _currentNode;
+  std::vector<DialogueTree::Node> _nodes;
+  std::vector<const char*> _lines;
+  std::vector<CommandParser::Command> _cmds;
+  std::string _stringPool;
 };
 
 
@@ -0,0 +1,496 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "SaveGame.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cocos2d.h>
+#include <zlib.h>
+#include "character/Player.h"
+#include "map/GameMapManager.h"
+#include "quest/KillTargetObjective.h"
+#include "skill/Skill.h"
+#include "util/Logger.h"
+
+using std::string;
+using std::vector;
+using cocos2d::FileUtils;
+using cocos2d::EventKeyboard;
+
+namespace {
+
+size_t align4(size_t size) {
+  return (size + 3) & ~static_cast<size_t>(3);
+}
+
+} // namespace
+
+
+namespace vigilante {
+
+const char SaveGame::_kMagic[4] = {'V', 'G', 'S', 'V'};
+const uint32_t SaveGame::_kVersion = 3;
+const int SaveGame::_kNumSlots = 2;
+const uint32_t SaveGame::_kMaxImageSize = 16 * 1024 * 1024;
+
+SaveGame::SaveGame(const string& saveFileName) : _saveFileName(saveFileName), _buffer() {}
+
+string SaveGame::getDefaultSaveFileName() {
+  return FileUtils::getInstance()->getWritablePath() + "vigilante.sav";
+}
+
+
+SaveGame::Snapshot SaveGame::capture() {
+  GameMapManager* gmMgr = GameMapManager::getInstance();
+  Player* player = gmMgr->getPlayer();
+  Snapshot snapshot;
+
+  // Current map and position.
+  snapshot.tmxMapFileName = gmMgr->getGameMap()->getTmxMapFileName();
+  snapshot.x = player->getBody()->GetPosition().x;
+  snapshot.y = player->getBody()->GetPosition().y;
+
+  // Profile stats.
+  const Character::Profile& profile = player->getCharacterProfile();
+  snapshot.player.level = profile.level;
+  snapshot.player.exp = profile.exp;
+  snapshot.player.fullHealth = profile.fullHealth;
+  snapshot.player.fullStamina = profile.fullStamina;
+  snapshot.player.fullMagicka = profile.fullMagicka;
+  snapshot.player.health = profile.health;
+  snapshot.player.stamina = profile.stamina;
+  snapshot.player.magicka = profile.magicka;
+  snapshot.player.strength = profile.strength;
+  snapshot.player.dexterity = profile.dexterity;
+  snapshot.player.intelligence = profile.intelligence;
+  snapshot.player.luck = profile.luck;
+  snapshot.player.baseMeleeDamage = profile.baseMeleeDamage;
+
+  // Equipment and hotkeys.
+  for (int i = 0; i < Equipment::Type::SIZE; i++) {
+    const Equipment* equipment = player->getEquipmentSlots()[i];
+    if (equipment) {
+      snapshot.equipmentSlots[i] = equipment->getItemProfile().jsonFileName;
+    }
+  }
+
+  for (int i = 0; i < HotkeyManager::BindableKeys::SIZE; i++) {
+    const HotkeyManager::Action& action = HotkeyManager::getInstance()->getAction(static_cast<HotkeyManager::BindableKeys>(i));
+    snapshot.hotkeys[i].first = HotkeyType::NONE;
+    if (action.type == HotkeyManager::Action::Type::SKILL) {
+      snapshot.hotkeys[i] = {HotkeyType::SKILL, action.skill->getSkillProfile().jsonFileName};
+    } else if (action.type == HotkeyManager::Action::Type::CONSUMABLE) {
+      snapshot.hotkeys[i] = {HotkeyType::ITEM, action.consumable->getItemProfile().jsonFileName};
+    }
+  }
+
+  // Inventory, skills and quests.
+  for (const auto& itemStacks : player->getInventory()) {
+    for (const auto& itemStack : itemStacks) {
+      snapshot.items.push_back({itemStack.item->getItemProfile().jsonFileName, itemStack.amount});
+    }
+  }
+
+  for (auto skill : player->getSkills()) {
+    snapshot.skills.push_back(skill->getSkillProfile().jsonFileName);
+  }
+
+  // The in-progress and completed quests go first (in their order),
+  // followed by the unlocked ones which haven't been started yet.
+  vector<Quest*> quests = player->getQuestBook().getAllQuests();
+  for (auto quest : player->getQuestBook().getLoadedQuests()) {
+    if (quest->getCurrentStageIdx() < 0 && quest->isUnlocked()) {
+      quests.push_back(quest);
+    }
+  }
+
+  for (auto quest : quests) {
+    Snapshot::QuestProgress progress = {quest->getQuestProfile().jsonFileName, quest->isUnlocked(), quest->getCurrentStageIdx(), 0};
+    if (!quest->isCompleted() && progress.stageIdx >= 0) {
+      if (auto objective = dynamic_cast<KillTargetObjective*>(quest->getCurrentStage().objective)) {
+        progress.objectiveCounter = objective->getCurrentAmount();
+      }
+    }
+    snapshot.quests.push_back(progress);
+  }
+
+  return snapshot;
+}
+
+bool SaveGame::save(const SaveGame::Snapshot& snapshot) const {
+  vector<char> image = serialize(snapshot);
+
+  // Write to the slot which doesn't hold the latest save. Only the slot
+  // headers are read: even if the latest one turns out to be corrupted,
+  // the other slot is only replaced once the new save is fully written.
+  int slot = 0;
+  uint32_t latestSequence = 0;
+  for (int i = 0; i < _kNumSlots; i++) {
+    FILE* fin = fopen(getSlotFileName(i).c_str(), "rb");
+    if (!fin) {
+      continue;
+    }
+    SlotHeader slotHeader;
+    if (readSlotHeader(fin, slotHeader) && slotHeader.sequence >= latestSequence) {
+      latestSequence = slotHeader.sequence;
+      slot = (i + 1) % _kNumSlots;
+    }
+    fclose(fin);
+  }
+
+  SlotHeader header;
+  memcpy(header.magic, _kMagic, sizeof(_kMagic));
+  header.version = _kVersion;
+  header.sequence = latestSequence + 1;
+  header.imageSize = image.size();
+
+  uLongf compressedSize = compressBound(image.size());
+  vector<char> buffer(sizeof(SlotHeader) + compressedSize);
+  Bytef* compressed = reinterpret_cast<Bytef*>(buffer.data() + sizeof(SlotHeader));
+  if (compress2(compressed, &compressedSize, reinterpret_cast<const Bytef*>(image.data()), image.size(), Z_BEST_SPEED) != Z_OK) {
+    VGLOG(LOG_ERR, "Failed to compress the save");
+    return false;
+  }
+  buffer.resize(sizeof(SlotHeader) + compressedSize);
+  header.compressedSize = compressedSize;
+  header.checksum = getSlotChecksum(header, buffer.data() + sizeof(SlotHeader));
+  memcpy(buffer.data(), &header, sizeof(SlotHeader));
+
+  // Write and fsync a temporary file, then rename it over the slot,
+  // so the slot always holds either the old or the new save.
+  string slotFileName = getSlotFileName(slot);
+  string tmpFileName = slotFileName + ".tmp";
+
+  FILE* fout = fopen(tmpFileName.c_str(), "wb");
+  if (!fout) {
+    VGLOG(LOG_ERR, "Failed to open %s for writing", tmpFileName.c_str());
+    return false;
+  }
+  bool isWritten = fwrite(buffer.data(), 1, buffer.size(), fout) == buffer.size();
+  isWritten = (fflush(fout) == 0) && isWritten;
+#ifdef _WIN32
+  isWritten = (_commit(_fileno(fout)) == 0) && isWritten;
+#else
+  isWritten = (fsync(fileno(fout)) == 0) && isWritten;
+#endif
+  isWritten = (fclose(fout) == 0) && isWritten;
+
+#ifdef _WIN32
+  // rename() doesn't replace an existing file on Windows.
+  // If we crash right here, the other slot still holds the previous save.
+  std::remove(slotFileName.c_str());
+#endif
+  if (!isWritten || std::rename(tmpFileName.c_str(), slotFileName.c_str()) != 0) {
+    VGLOG(LOG_ERR, "Failed to write %s", slotFileName.c_str());
+    std::remove(tmpFileName.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool SaveGame::exists() const {
+  for (int i = 0; i < _kNumSlots; i++) {
+    if (FileUtils::getInstance()->isFileExist(getSlotFileName(i))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SaveGame::load() {
+  _buffer.clear();
+
+  uint32_t latestSequence = 0;
+  for (int i = 0; i < _kNumSlots; i++) {
+    uint32_t sequence;
+    vector<char> image;
+    if (!readSlot(i, sequence, image) || (!_buffer.empty() && sequence <= latestSequence)) {
+      continue;
+    }
+
+    // Fall back to the other slot if this image is broken.
+    vector<char> previousImage = std::move(_buffer);
+    _buffer = std::move(image);
+    if (isValidImage()) {
+      latestSequence = sequence;
+    } else {
+      VGLOG(LOG_WARN, "Corrupted save: %s", getSlotFileName(i).c_str());
+      _buffer = std::move(previousImage);
+    }
+  }
+
+  return !_buffer.empty();
+}
+
+
+vector<char> SaveGame::serialize(const SaveGame::Snapshot& snapshot) {
+  static_assert(sizeof(Header) % 4 == 0 && sizeof(ItemRecord) % 4 == 0 && sizeof(QuestRecord) % 4 == 0,
+                "SaveGame records must be 4-byte aligned");
+
+  Header header;
+  memset(&header, 0, sizeof(header));
+
+  string strings;
+  auto addString = [&strings](const string& s) {
+    StringRef ref = {static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(s.size())};
+    strings += s;
+    return ref;
+  };
+
+  header.tmxMapFileName = addString(snapshot.tmxMapFileName);
+  header.x = snapshot.x;
+  header.y = snapshot.y;
+  header.player = snapshot.player;
+
+  for (int i = 0; i < Equipment::Type::SIZE; i++) {
+    header.equipmentSlots[i] = addString(snapshot.equipmentSlots[i]);
+  }
+  for (int i = 0; i < HotkeyManager::BindableKeys::SIZE; i++) {
+    header.hotkeys[i] = {snapshot.hotkeys[i].first, addString(snapshot.hotkeys[i].second)};
+  }
+
+  vector<ItemRecord> items;
+  for (const auto& item : snapshot.items) {
+    items.push_back({addString(item.first), item.second});
+  }
+
+  vector<StringRef> skills;
+  for (const auto& skill : snapshot.skills) {
+    skills.push_back(addString(skill));
+  }
+
+  vector<QuestRecord> quests;
+  for (const auto& quest : snapshot.quests) {
+    quests.push_back({addString(quest.jsonFileName), quest.isUnlocked, quest.stageIdx, quest.objectiveCounter});
+  }
+
+  // Lay out the sections after the header.
+  size_t offset = sizeof(Header);
+  header.items = {static_cast<uint32_t>(offset), static_cast<uint32_t>(items.size())};
+  offset += items.size() * sizeof(ItemRecord);
+  header.skills = {static_cast<uint32_t>(offset), static_cast<uint32_t>(skills.size())};
+  offset += skills.size() * sizeof(StringRef);
+  header.quests = {static_cast<uint32_t>(offset), static_cast<uint32_t>(quests.size())};
+  offset += quests.size() * sizeof(QuestRecord);
+  header.strings = {static_cast<uint32_t>(offset), static_cast<uint32_t>(strings.size())};
+  offset += strings.size();
+
+  vector<char> image(align4(offset));
+  memcpy(image.data(), &header, sizeof(Header));
+  memcpy(image.data() + header.items.offset, items.data(), items.size() * sizeof(ItemRecord));
+  memcpy(image.data() + header.skills.offset, skills.data(), skills.size() * sizeof(StringRef));
+  memcpy(image.data() + header.quests.offset, quests.data(), quests.size() * sizeof(QuestRecord));
+  memcpy(image.data() + header.strings.offset, strings.data(), strings.size());
+  return image;
+}
+
+string SaveGame::getSlotFileName(int slot) const {
+  return _saveFileName + "." + std::to_string(slot);
+}
+
+bool SaveGame::readSlotHeader(FILE* fin, SaveGame::SlotHeader& header) {
+  if (fseek(fin, 0, SEEK_END) != 0) {
+    return false;
+  }
+  long fileSize = ftell(fin);
+  rewind(fin);
+
+  return fileSize >= static_cast<long>(sizeof(SlotHeader))
+    && fread(&header, 1, sizeof(SlotHeader), fin) == sizeof(SlotHeader)
+    && memcmp(header.magic, _kMagic, sizeof(_kMagic)) == 0
+    && header.version == _kVersion
+    && header.compressedSize == static_cast<unsigned long>(fileSize) - sizeof(SlotHeader)
+    && header.imageSize <= _kMaxImageSize;
+}
+
+bool SaveGame::readSlot(int slot, uint32_t& sequence, vector<char>& image) const {
+  FILE* fin = fopen(getSlotFileName(slot).c_str(), "rb");
+  if (!fin) {
+    return false;
+  }
+
+  // The sizes are bounded by readSlotHeader(), and the header is covered
+  // by the checksum, before anything is decompressed.
+  SlotHeader header;
+  vector<char> compressed;
+  bool isRead = readSlotHeader(fin, header);
+  if (isRead) {
+    compressed.resize(header.compressedSize);
+    isRead = fread(compressed.data(), 1, compressed.size(), fin) == compressed.size()
+      && header.checksum == getSlotChecksum(header, compressed.data());
+  }
+  fclose(fin);
+
+  if (!isRead) {
+    return false;
+  }
+
+  uLongf imageSize = header.imageSize;
+  image.resize(imageSize);
+  if (uncompress(reinterpret_cast<Bytef*>(image.data()), &imageSize,
+                 reinterpret_cast<const Bytef*>(compressed.data()), compressed.size()) != Z_OK
+      || imageSize != header.imageSize) {
+    return false;
+  }
+  sequence = header.sequence;
+  return true;
+}
+
+bool SaveGame::isValidImage() const {
+  // Validate everything up front, so the records can be used as is afterwards.
+  const Header* header = getHeader();
+  bool isValid = header
+    && isValidSection(header->items, sizeof(ItemRecord))
+    && isValidSection(header->skills, sizeof(StringRef))
+    && isValidSection(header->quests, sizeof(QuestRecord))
+    && isValidSection(header->strings, 1)
+    && isValidString(header->tmxMapFileName);
+
+  for (int i = 0; isValid && i < Equipment::Type::SIZE; i++) {
+    isValid = isValidString(header->equipmentSlots[i]);
+  }
+  for (int i = 0; isValid && i < HotkeyManager::BindableKeys::SIZE; i++) {
+    isValid = isValidString(header->hotkeys[i].jsonFileName);
+  }
+  for (uint32_t i = 0; isValid && i < header->items.count; i++) {
+    isValid = isValidString(getRecords<ItemRecord>(header->items)[i].jsonFileName);
+  }
+  for (uint32_t i = 0; isValid && i < header->skills.count; i++) {
+    isValid = isValidString(getRecords<StringRef>(header->skills)[i]);
+  }
+  for (uint32_t i = 0; isValid && i < header->quests.count; i++) {
+    isValid = isValidString(getRecords<QuestRecord>(header->quests)[i].jsonFileName);
+  }
+  return isValid;
+}
+
+
+string SaveGame::getTmxMapFileName() const {
+  return getString(getHeader()->tmxMapFileName);
+}
+
+void SaveGame::restore(Player* player) const {
+  const Header* header = getHeader();
+
+  Character::Profile& profile = player->getCharacterProfile();
+  profile.level = header->player.level;
+  profile.exp = header->player.exp;
+  profile.fullHealth = header->player.fullHealth;
+  profile.fullStamina = header->player.fullStamina;
+  profile.fullMagicka = header->player.fullMagicka;
+  profile.health = header->player.health;
+  profile.stamina = header->player.stamina;
+  profile.magicka = header->player.magicka;
+  profile.strength = header->player.strength;
+  profile.dexterity = header->player.dexterity;
+  profile.intelligence = header->player.intelligence;
+  profile.luck = header->player.luck;
+  profile.baseMeleeDamage = header->player.baseMeleeDamage;
+
+  const ItemRecord* items = getRecords<ItemRecord>(header->items);
+  for (uint32_t i = 0; i < header->items.count; i++) {
+    player->addItem(getString(items[i].jsonFileName), items[i].amount);
+  }
+
+  // An equipment has to be in the inventory to be equipped.
+  for (int i = 0; i < Equipment::Type::SIZE; i++) {
+    if (header->equipmentSlots[i].length == 0) {
+      continue;
+    }
+    string jsonFileName = getString(header->equipmentSlots[i]);
+    player->addItem(jsonFileName, 1);
+    if (const Equipment* equipment = dynamic_cast<const Equipment*>(Item::getPrototype(jsonFileName))) {
+      player->equip(equipment);
+    }
+  }
+
+  const StringRef* skills = getRecords<StringRef>(header->skills);
+  for (uint32_t i = 0; i < header->skills.count; i++) {
+    player->addSkill(Skill::create(getString(skills[i]), player));
+  }
+
+  for (int i = 0; i < HotkeyManager::BindableKeys::SIZE; i++) {
+    const HotkeyRecord& record = header->hotkeys[i];
+    string jsonFileName = getString(record.jsonFileName);
+    EventKeyboard::KeyCode keyCode = HotkeyManager::_kBindableKeys[i];
+
+    if (record.type == HotkeyType::SKILL) {
+      for (auto skill : player->getSkills()) {
+        if (skill->getSkillProfile().jsonFileName == jsonFileName) {
+          HotkeyManager::getInstance()->setHotkeyAction(keyCode, skill);
+          break;
+        }
+      }
+    } else if (record.type == HotkeyType::ITEM) {
+      // Ignored unless the player still has some of this consumable.
+      if (const Consumable* consumable = dynamic_cast<const Consumable*>(Item::getPrototype(jsonFileName))) {
+        HotkeyManager::getInstance()->setHotkeyAction(keyCode, player, consumable);
+      }
+    }
+  }
+
+  const QuestRecord* quests = getRecords<QuestRecord>(header->quests);
+  for (uint32_t i = 0; i < header->quests.count; i++) {
+    Quest* quest = player->getQuestBook().restoreQuest(getString(quests[i].jsonFileName), quests[i].stageIdx);
+    if (!quest) {
+      continue;
+    }
+    if (quests[i].isUnlocked) {
+      quest->unlock();
+    }
+    if (!quest->isCompleted() && quest->getCurrentStageIdx() >= 0) {
+      if (auto objective = dynamic_cast<KillTargetObjective*>(quest->getCurrentStage().objective)) {
+        objective->setCurrentAmount(quests[i].objectiveCounter);
+      }
+    }
+  }
+
+  player->setPosition(header->x, header->y);
+}
+
+
+uint32_t SaveGame::getChecksum(const char* data, size_t size, uint32_t hash) {
+  // 32-bit FNV-1a
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+  }
+  return hash;
+}
+
+uint32_t SaveGame::getSlotChecksum(const SaveGame::SlotHeader& header, const char* compressed) {
+  SlotHeader h = header;
+  h.checksum = 0;
+  uint32_t hash = getChecksum(reinterpret_cast<const char*>(&h), sizeof(SlotHeader));
+  return getChecksum(compressed, header.compressedSize, hash);
+}
+
+const SaveGame::Header* SaveGame::getHeader() const {
+  return (_buffer.size() >= sizeof(Header)) ? reinterpret_cast<const Header*>(_buffer.data()) : nullptr;
+}
+
+template <typename T>
+const T* SaveGame::getRecords(const SaveGame::Section& section) const {
+  return reinterpret_cast<const T*>(_buffer.data() + section.offset);
+}
+
+string SaveGame::getString(const SaveGame::StringRef& ref) const {
+  return string(_buffer.data() + getHeader()->strings.offset + ref.offset, ref.length);
+}
+
+bool SaveGame::isValidSection(const SaveGame::Section& section, size_t recordSize) const {
+  return section.offset >= sizeof(Header)
+    && section.offset % 4 == 0
+    && section.offset + static_cast<uint64_t>(section.count) * recordSize <= _buffer.size();
+}
+
+bool SaveGame::isValidString(const SaveGame::StringRef& ref) const {
+  return static_cast<uint64_t>(ref.offset) + ref.length <= getHeader()->strings.count;
+}
+
+} // namespace vigilante
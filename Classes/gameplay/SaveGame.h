@@ -0,0 +1,192 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_SAVE_GAME_H_
+#define VIGILANTE_SAVE_GAME_H_
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "input/HotkeyManager.h"
+#include "item/Equipment.h"
+
+namespace vigilante {
+
+class Player;
+
+// SaveGame reads/writes the versioned binary save file, which covers the
+// player's profile stats, inventory, equipment, skills, hotkeys, quest
+// progress, and the current map and position.
+//
+// Saving is split in two, so that it can be done in the background (see AutoSave.h):
+// capture() copies the game state into a SaveGame::Snapshot on the main thread,
+// and save(snapshot) serializes, compresses and writes it on any thread.
+//
+// The save consists of two slot files (<saveFileName>.0 and .1). Each save goes
+// to the slot which doesn't hold the latest valid save, via a temporary file
+// which is fsync'ed and then renamed over the slot, so a crash mid-write never
+// loses the previous save. load() picks the valid slot with the larger sequence.
+//
+// A slot file is a SaveGame::SlotHeader followed by the zlib-compressed image.
+// The image is a SaveGame::Header followed by fixed-size records and a string
+// blob, all 4-byte aligned. Records refer to strings by (offset, length), and
+// the header refers to the record arrays by (offset, count). Once inflated and
+// validated, the records are used in place without any parsing.
+//
+// The file is in the native byte order (little-endian on all supported platforms).
+class SaveGame {
+ public:
+  enum HotkeyType : uint32_t {
+    NONE,
+    SKILL,
+    ITEM
+  };
+
+  struct PlayerRecord {
+    int32_t level;
+    int32_t exp;
+    int32_t fullHealth;
+    int32_t fullStamina;
+    int32_t fullMagicka;
+    int32_t health;
+    int32_t stamina;
+    int32_t magicka;
+    int32_t strength;
+    int32_t dexterity;
+    int32_t intelligence;
+    int32_t luck;
+    int32_t baseMeleeDamage;
+  };
+
+  // A copy of the game state to be saved. It doesn't refer to any
+  // game object, so it can be saved from another thread.
+  struct Snapshot {
+    struct QuestProgress {
+      std::string jsonFileName;
+      bool isUnlocked;
+      int stageIdx;
+      int objectiveCounter; // e.g., the number of killed targets
+    };
+
+    std::string tmxMapFileName;
+    float x;
+    float y;
+    SaveGame::PlayerRecord player;
+    std::array<std::string, Equipment::Type::SIZE> equipmentSlots;
+    std::array<std::pair<SaveGame::HotkeyType, std::string>, HotkeyManager::BindableKeys::SIZE> hotkeys;
+    std::vector<std::pair<std::string, int>> items; // <json, amount>
+    std::vector<std::string> skills;
+    std::vector<SaveGame::Snapshot::QuestProgress> quests;
+  };
+
+  explicit SaveGame(const std::string& saveFileName);
+  virtual ~SaveGame() = default;
+
+  // The save file in the user's writable directory.
+  static std::string getDefaultSaveFileName();
+
+  // Copies the current game state. Must be called on the main thread.
+  static SaveGame::Snapshot capture();
+
+  // Serializes, compresses and writes the snapshot into a slot.
+  // Returns false if the file can't be written.
+  bool save(const SaveGame::Snapshot& snapshot) const;
+
+  // Is there any save?
+  bool exists() const;
+
+  // Reads and validates the latest save.
+  // Returns false if there's none or all of them are corrupted.
+  bool load();
+
+  // The following are only valid after a successful load().
+  std::string getTmxMapFileName() const;
+  // Restores the player's state from the save. The player should be
+  // freshly created, i.e. with empty inventory, equipment and skills.
+  void restore(Player* player) const;
+
+ private:
+  static const char _kMagic[4];
+  static const uint32_t _kVersion;
+  static const int _kNumSlots;
+  static const uint32_t _kMaxImageSize; // larger images are treated as corrupted
+
+  struct SlotHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t sequence; // incremented by each save
+    uint32_t imageSize;
+    uint32_t compressedSize;
+    uint32_t checksum; // of this header (with checksum = 0) and the compressed image
+  };
+
+  struct StringRef {
+    uint32_t offset; // relative to the string blob
+    uint32_t length;
+  };
+
+  struct Section {
+    uint32_t offset; // relative to the beginning of the image
+    uint32_t count;
+  };
+
+  struct HotkeyRecord {
+    SaveGame::HotkeyType type;
+    SaveGame::StringRef jsonFileName;
+  };
+
+  struct ItemRecord {
+    SaveGame::StringRef jsonFileName;
+    int32_t amount;
+  };
+
+  struct QuestRecord {
+    SaveGame::StringRef jsonFileName;
+    uint32_t isUnlocked;
+    int32_t stageIdx;
+    int32_t objectiveCounter;
+  };
+
+  struct Header {
+    SaveGame::StringRef tmxMapFileName;
+    float x;
+    float y;
+
+    SaveGame::PlayerRecord player;
+    SaveGame::StringRef equipmentSlots[Equipment::Type::SIZE];
+    SaveGame::HotkeyRecord hotkeys[HotkeyManager::BindableKeys::SIZE];
+
+    SaveGame::Section items; // ItemRecord[]
+    SaveGame::Section skills; // StringRef[]
+    SaveGame::Section quests; // QuestRecord[]
+    SaveGame::Section strings; // char[]
+  };
+
+  static std::vector<char> serialize(const SaveGame::Snapshot& snapshot);
+  static uint32_t getChecksum(const char* data, size_t size, uint32_t hash=2166136261u);
+  static uint32_t getSlotChecksum(const SaveGame::SlotHeader& header, const char* compressed);
+
+  std::string getSlotFileName(int slot) const;
+  // Reads the slot header and checks it against the file size, without
+  // reading the image. Returns false if it's obviously corrupted.
+  static bool readSlotHeader(FILE* fin, SaveGame::SlotHeader& header);
+  // Returns false if the slot doesn't exist or is corrupted.
+  bool readSlot(int slot, uint32_t& sequence, std::vector<char>& image) const;
+  bool isValidImage() const;
+
+  const SaveGame::Header* getHeader() const;
+  template <typename T>
+  const T* getRecords(const SaveGame::Section& section) const;
+  std::string getString(const SaveGame::StringRef& ref) const;
+  bool isValidSection(const SaveGame::Section& section, size_t recordSize) const;
+  bool isValidString(const SaveGame::StringRef& ref) const;
+
+  std::string _saveFileName;
+  std::vector<char> _buffer; // the loaded image
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_SAVE_GAME_H_
@@ -1,7 +1,10 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "HotkeyManager.h"
 
+#include "character/Character.h"
 #include "input/InputManager.h"
+#include "item/Consumable.h"
+#include "skill/Skill.h"
 #include "ui/pause_menu/PauseMenuDialog.h"
 #include "util/Logger.h"
 
@@ -12,6 +15,7 @@ using cocos2d::EventKeyboard;
 namespace vigilante {
 
 HotkeyManager* HotkeyManager::_instance = nullptr;
+const int HotkeyManager::_kKeyCodeTableSize = 256;
 
 const array<EventKeyboard::KeyCode, HotkeyManager::BindableKeys::SIZE> HotkeyManager::_kBindableKeys = {{
   EventKeyboard::KeyCode::KEY_LEFT_SHIFT,
@@ -28,48 +32,67 @@ HotkeyManager* HotkeyManager::getInstance() {
   return _instance;
 }
 
-HotkeyManager::HotkeyManager() : _hotkeys() {}
+HotkeyManager::HotkeyManager() : _hotkeys(), _version(1) {}
 
 
+const HotkeyManager::Action& HotkeyManager::getAction(HotkeyManager::BindableKeys bindableKey) const {
+  return _hotkeys[bindableKey];
+}
+
 Keybindable* HotkeyManager::getHotkeyAction(EventKeyboard::KeyCode keyCode) const {
-  for (size_t i = 0; i < _kBindableKeys.size(); i++) {
-    if (keyCode == _kBindableKeys[i]) {
-      return _hotkeys[i];
-    }
-  }
-  return nullptr;
+  BindableKeys bindableKey = getBindableKey(keyCode);
+  return (bindableKey != BindableKeys::SIZE) ? _hotkeys[bindableKey].keybindable : nullptr;
 }
 
 void HotkeyManager::setHotkeyAction(EventKeyboard::KeyCode keyCode, Keybindable* keybindable) {
-  for (size_t i = 0; i < _kBindableKeys.size(); i++) {
-    if (keyCode == _kBindableKeys[i]) {
-      clearHotkeyAction(keybindable->getHotkey());
-      if (_hotkeys[i]) {
-        clearHotkeyAction(_hotkeys[i]->getHotkey());
-      }
-
-      _hotkeys[i] = keybindable;
-      keybindable->setHotkey(keyCode);
-      return;
-    }
+  BindableKeys bindableKey = getBindableKey(keyCode);
+  if (bindableKey == BindableKeys::SIZE) {
+    return;
   }
+
+  clearHotkeyAction(keybindable->getHotkey());
+  clearHotkeyAction(keyCode);
+
+  // Resolve the type of this action once here, instead of every time it's used.
+  Action& action = _hotkeys[bindableKey];
+  action = {Action::Type::NONE, keybindable, nullptr, nullptr, nullptr};
+  if ((action.skill = dynamic_cast<Skill*>(keybindable))) {
+    action.type = Action::Type::SKILL;
+  }
+
+  keybindable->setHotkey(keyCode);
+  _version++;
+}
+
+void HotkeyManager::setHotkeyAction(EventKeyboard::KeyCode keyCode, Character* owner, const Consumable* consumable) {
+  BindableKeys bindableKey = getBindableKey(keyCode);
+  const Character::ItemStack* itemStack = owner->getItemStack(consumable);
+  if (bindableKey == BindableKeys::SIZE || !itemStack) {
+    return;
+  }
+
+  clearHotkeyAction(itemStack->hotkey);
+  clearHotkeyAction(keyCode);
+
+  _hotkeys[bindableKey] = {Action::Type::CONSUMABLE, nullptr, nullptr, owner, consumable};
+  owner->setItemHotkey(consumable, keyCode);
+  _version++;
 }
 
 void HotkeyManager::clearHotkeyAction(EventKeyboard::KeyCode keyCode) {
-  // If keyCode == KeyCode::KEY_NONE, return at once.
-  if (!static_cast<bool>(keyCode)) {
+  BindableKeys bindableKey = getBindableKey(keyCode);
+  if (bindableKey == BindableKeys::SIZE) {
     return;
   }
 
-  for (size_t i = 0; i < _kBindableKeys.size(); i++) {
-    if (keyCode == _kBindableKeys[i]) {
-      if (_hotkeys[i]) {
-        _hotkeys[i]->setHotkey(EventKeyboard::KeyCode::KEY_NONE);
-      }
-      _hotkeys[i] = nullptr;
-      return;
-    }
+  const Action& action = _hotkeys[bindableKey];
+  if (action.keybindable) {
+    action.keybindable->setHotkey(EventKeyboard::KeyCode::KEY_NONE);
+  } else if (action.type == Action::Type::CONSUMABLE) {
+    action.owner->setItemHotkey(action.consumable, EventKeyboard::KeyCode::KEY_NONE);
   }
+  _hotkeys[bindableKey] = {Action::Type::NONE, nullptr, nullptr, nullptr, nullptr};
+  _version++;
 }
 
 void HotkeyManager::promptHotkey(Keybindable* keybindable, PauseMenuDialog* pauseMenuDialog) {
@@ -85,4 +108,25 @@ void HotkeyManager::promptHotkey(Keybindable* keybindable, PauseMenuDialog* paus
   InputManager::getInstance()->pushEvLstnr(onKeyPressedEvLstnr);
 }
 
+
+uint32_t HotkeyManager::getVersion() const {
+  return _version;
+}
+
+
+HotkeyManager::BindableKeys HotkeyManager::getBindableKey(EventKeyboard::KeyCode keyCode) {
+  // Built once from _kBindableKeys, so that the two can't go out of sync.
+  static const array<BindableKeys, _kKeyCodeTableSize> keyCodeTable = []() {
+    array<BindableKeys, _kKeyCodeTableSize> table;
+    table.fill(BindableKeys::SIZE);
+    for (int i = 0; i < BindableKeys::SIZE; i++) {
+      table[static_cast<int>(_kBindableKeys[i])] = static_cast<BindableKeys>(i);
+    }
+    return table;
+  }();
+
+  int index = static_cast<int>(keyCode);
+  return (index >= 0 && index < _kKeyCodeTableSize) ? keyCodeTable[index] : BindableKeys::SIZE;
+}
+
 } // namespace vigilante
@@ -11,6 +11,9 @@
 namespace vigilante {
 
 class PauseMenuDialog;
+class Character;
+class Skill;
+class Consumable;
 
 class HotkeyManager {
  public:
@@ -28,16 +31,45 @@ class HotkeyManager {
 
   static const std::array<cocos2d::EventKeyboard::KeyCode, BindableKeys::SIZE> _kBindableKeys;
 
+  // A bound action, whose type is resolved once when it's bound,
+  // so that it can be invoked directly (see Player::handleInput()).
+  struct Action {
+    enum Type {
+      NONE,
+      SKILL,
+      CONSUMABLE
+    };
+
+    HotkeyManager::Action::Type type;
+    Keybindable* keybindable; // SKILL only
+    Skill* skill; // SKILL only
+    Character* owner; // CONSUMABLE only
+    const Consumable* consumable; // CONSUMABLE only
+  };
+
+  const HotkeyManager::Action& getAction(HotkeyManager::BindableKeys bindableKey) const;
+
   Keybindable* getHotkeyAction(cocos2d::EventKeyboard::KeyCode keyCode) const;
   void setHotkeyAction(cocos2d::EventKeyboard::KeyCode keyCode, Keybindable* keybindable);
+  // Consumables are shared, so their hotkey is kept in the owner's ItemStack instead
+  // (see Character::ItemStack). Does nothing if the owner has none of `consumable`.
+  void setHotkeyAction(cocos2d::EventKeyboard::KeyCode keyCode, Character* owner, const Consumable* consumable);
   void clearHotkeyAction(cocos2d::EventKeyboard::KeyCode keyCode);
   void promptHotkey(Keybindable* keybindable, PauseMenuDialog* pauseMenuDialog);
 
+  // Bumped whenever a hotkey is set or cleared. Starts at 1 (see Character::getInventoryVersion()).
+  uint32_t getVersion() const;
+
  private:
   static HotkeyManager* _instance;
+  static const int _kKeyCodeTableSize; // every cocos2d::EventKeyboard::KeyCode is below this
   HotkeyManager();
 
-  std::array<Keybindable*, BindableKeys::SIZE> _hotkeys;
+  // Returns BindableKeys::SIZE if keyCode is not bindable.
+  static HotkeyManager::BindableKeys getBindableKey(cocos2d::EventKeyboard::KeyCode keyCode);
+
+  std::array<HotkeyManager::Action, BindableKeys::SIZE> _hotkeys;
+  uint32_t _version;
 };
 
 } // namespace vigilante
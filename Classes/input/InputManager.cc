@@ -1,9 +1,9 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "input/InputManager.h"
 
+#include "input/InputRecorder.h"
 #include "util/Logger.h"
 
-using std::set;
 using cocos2d::Scene;
 using cocos2d::Event;
 using cocos2d::EventKeyboard;
@@ -11,6 +11,8 @@ using cocos2d::EventListenerKeyboard;
 
 namespace vigilante {
 
+const uint32_t InputManager::_kKeyPressBufferTicks = 8;
+
 InputManager* InputManager::_instance = nullptr;
 
 InputManager* InputManager::getInstance() {
@@ -21,29 +23,38 @@ InputManager* InputManager::getInstance() {
 }
 
 InputManager::InputManager()
-    : _scene(), _keyboardEvLstnr(), _pressedKeys(), _isCapsLocked() {}
+    : _scene(),
+      _keyboardEvLstnr(),
+      _pressedKeys(),
+      _justPressedKeys(),
+      _justReleasedKeys(),
+      _keyPresses(),
+      _nextKeyPressIdx(),
+      _tick(),
+      _isCapsLocked() {}
 
 
 void InputManager::activate(Scene* scene) {
+  reset();
   _scene = scene;
   _keyboardEvLstnr = EventListenerKeyboard::create();
 
   // Capture "this" by value.
+  // While a replay is running, the real keyboard is ignored.
   _keyboardEvLstnr->onKeyPressed = [=](EventKeyboard::KeyCode keyCode, Event* e) {
-    _pressedKeys.insert(keyCode);
-
-    if (keyCode == EventKeyboard::KeyCode::KEY_CAPS_LOCK) {
-      _isCapsLocked = !_isCapsLocked;
-    }
-
-    // Execute additional OnKeyPressedEvLstnrs.
-    if (!_onKeyPressedEvLstnrs.empty()) {
-      _onKeyPressedEvLstnrs.top()(keyCode, e);
+    InputRecorder* recorder = InputRecorder::getInstance();
+    if (!recorder->isReplaying()) {
+      recorder->recordKeyEvent(keyCode, true);
+      pressKey(keyCode, e);
     }
   };
 
   _keyboardEvLstnr->onKeyReleased = [=](EventKeyboard::KeyCode keyCode, Event*) {
-    _pressedKeys.erase(keyCode);
+    InputRecorder* recorder = InputRecorder::getInstance();
+    if (!recorder->isReplaying()) {
+      recorder->recordKeyEvent(keyCode, false);
+      releaseKey(keyCode);
+    }
   };
   
   _scene->getEventDispatcher()->addEventListenerWithSceneGraphPriority(_keyboardEvLstnr, scene);
@@ -53,16 +64,75 @@ void InputManager::deactivate() {
   _scene->getEventDispatcher()->removeEventListener(_keyboardEvLstnr);
   _keyboardEvLstnr = nullptr;
   _scene = nullptr;
+  reset();
 }
 
 
 bool InputManager::isKeyPressed(EventKeyboard::KeyCode keyCode) const {
-  return _pressedKeys.find(keyCode) != _pressedKeys.end();
+  size_t idx = getKeyIdx(keyCode);
+  return idx < _kMaxKeyCodes && (_pressedKeys[idx] || _justPressedKeys[idx]);
 }
 
-bool InputManager::isKeyJustPressed(EventKeyboard::KeyCode keyCode) {
-  // std::set::erase() returns the number of elements erased.
-  return _pressedKeys.erase(keyCode) > 0;
+bool InputManager::isKeyJustPressed(EventKeyboard::KeyCode keyCode) const {
+  size_t idx = getKeyIdx(keyCode);
+  return idx < _kMaxKeyCodes && _justPressedKeys[idx];
+}
+
+bool InputManager::isKeyJustReleased(EventKeyboard::KeyCode keyCode) const {
+  size_t idx = getKeyIdx(keyCode);
+  return idx < _kMaxKeyCodes && _justReleasedKeys[idx];
+}
+
+bool InputManager::consumeKeyPress(EventKeyboard::KeyCode keyCode, uint32_t maxAgeTicks) {
+  KeyPress* latest = nullptr;
+  for (auto& keyPress : _keyPresses) {
+    if (keyPress.keyCode == keyCode && _tick - keyPress.tick <= maxAgeTicks
+        && (!latest || keyPress.tick > latest->tick)) {
+      latest = &keyPress;
+    }
+  }
+
+  if (!latest) {
+    return false;
+  }
+  latest->keyCode = EventKeyboard::KeyCode::KEY_NONE;
+  return true;
+}
+
+void InputManager::nextTick() {
+  _justPressedKeys.reset();
+  _justReleasedKeys.reset();
+  _tick++;
+}
+
+
+void InputManager::pressKey(EventKeyboard::KeyCode keyCode, Event* e) {
+  size_t idx = getKeyIdx(keyCode);
+
+  // Auto-repeated key events of a held key are not presses.
+  if (idx < _kMaxKeyCodes && !_pressedKeys[idx]) {
+    _pressedKeys.set(idx);
+    _justPressedKeys.set(idx);
+    _keyPresses[_nextKeyPressIdx] = {keyCode, _tick};
+    _nextKeyPressIdx = (_nextKeyPressIdx + 1) % _keyPresses.size();
+  }
+
+  if (keyCode == EventKeyboard::KeyCode::KEY_CAPS_LOCK) {
+    _isCapsLocked = !_isCapsLocked;
+  }
+
+  // Execute additional OnKeyPressedEvLstnrs.
+  if (!_onKeyPressedEvLstnrs.empty()) {
+    _onKeyPressedEvLstnrs.top()(keyCode, e);
+  }
+}
+
+void InputManager::releaseKey(EventKeyboard::KeyCode keyCode) {
+  size_t idx = getKeyIdx(keyCode);
+  if (idx < _kMaxKeyCodes && _pressedKeys[idx]) {
+    _pressedKeys.reset(idx);
+    _justReleasedKeys.set(idx);
+  }
 }
 
 
@@ -85,4 +155,16 @@ bool InputManager::isShiftPressed() const {
   return isKeyPressed(EventKeyboard::KeyCode::KEY_SHIFT);
 }
 
+
+void InputManager::reset() {
+  _pressedKeys.reset();
+  _justPressedKeys.reset();
+  _justReleasedKeys.reset();
+  _keyPresses.fill({EventKeyboard::KeyCode::KEY_NONE, 0});
+}
+
+size_t InputManager::getKeyIdx(EventKeyboard::KeyCode keyCode) {
+  return static_cast<size_t>(keyCode);
+}
+
 } // namespace vigilante
@@ -2,8 +2,10 @@
 #ifndef VIGILANTE_INPUT_MANAGER_H_
 #define VIGILANTE_INPUT_MANAGER_H_
 
-#include <set>
+#include <array>
+#include <bitset>
 #include <stack>
+#include <cstdint>
 #include <functional>
 
 #include <cocos2d.h>
@@ -21,8 +23,24 @@ class InputManager {
   void activate(cocos2d::Scene* scene);
   void deactivate();
 
+  // Is this key held down (or has it been tapped since the last tick)?
   bool isKeyPressed(cocos2d::EventKeyboard::KeyCode keyCode) const;
-  bool isKeyJustPressed(cocos2d::EventKeyboard::KeyCode keyCode);
+  // Has this key been pressed/released since the last tick?
+  // These don't consume anything, so every check within the same tick gets the same answer.
+  bool isKeyJustPressed(cocos2d::EventKeyboard::KeyCode keyCode) const;
+  bool isKeyJustReleased(cocos2d::EventKeyboard::KeyCode keyCode) const;
+
+  // Consumes the latest press of this key from the last `maxAgeTicks` ticks, if any.
+  // e.g., an attack pressed while the player is still attacking comes out right after.
+  bool consumeKeyPress(cocos2d::EventKeyboard::KeyCode keyCode, uint32_t maxAgeTicks=_kKeyPressBufferTicks);
+
+  // Called once per simulation tick, after all the input of this tick has been handled.
+  void nextTick();
+
+  // Keyboard events from cocos2d are handled by these, and so are the
+  // ones played back by InputRecorder.
+  void pressKey(cocos2d::EventKeyboard::KeyCode keyCode, cocos2d::Event* e=nullptr);
+  void releaseKey(cocos2d::EventKeyboard::KeyCode keyCode);
 
   using OnKeyPressedEvLstnr = std::function<void (cocos2d::EventKeyboard::KeyCode, cocos2d::Event*)>;
   void pushEvLstnr(const OnKeyPressedEvLstnr& evLstnr);
@@ -35,12 +53,31 @@ class InputManager {
   static InputManager* _instance;
   InputManager();
 
+  struct KeyPress {
+    cocos2d::EventKeyboard::KeyCode keyCode; // KEY_NONE if consumed
+    uint32_t tick;
+  };
+
+  // Releases all keys, since the key events are not received while deactivated.
+  void reset();
+  static size_t getKeyIdx(cocos2d::EventKeyboard::KeyCode keyCode);
+
+  static const size_t _kMaxKeyCodes = 256;
+  static const uint32_t _kKeyPressBufferTicks;
+
   cocos2d::Scene* _scene;
   cocos2d::EventListenerKeyboard* _keyboardEvLstnr;
 
-  // Pressed Keys are stored in this set.
-  // Relevant method: isKeyPressed(), isKeyJustPressed()
-  std::set<cocos2d::EventKeyboard::KeyCode> _pressedKeys;
+  // Relevant method: isKeyPressed(), isKeyJustPressed(), isKeyJustReleased()
+  std::bitset<_kMaxKeyCodes> _pressedKeys; // currently held down
+  std::bitset<_kMaxKeyCodes> _justPressedKeys; // since the last tick
+  std::bitset<_kMaxKeyCodes> _justReleasedKeys; // since the last tick
+
+  // The recent key presses, timestamped with the tick they arrived in.
+  // Relevant method: consumeKeyPress()
+  std::array<InputManager::KeyPress, 16> _keyPresses;
+  size_t _nextKeyPressIdx;
+  uint32_t _tick;
 
   // The functor at the top of the stack will be called whenever
   // an onKeyPressed Event arrives.
@@ -0,0 +1,205 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "InputRecorder.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "input/InputManager.h"
+#include "util/Logger.h"
+
+using std::string;
+using std::ifstream;
+using std::ofstream;
+using std::istringstream;
+using std::runtime_error;
+using cocos2d::EventKeyboard;
+
+namespace vigilante {
+
+InputRecorder* InputRecorder::_instance = nullptr;
+
+const string InputRecorder::_kFileHeader = "vigilante-replay 1";
+
+InputRecorder* InputRecorder::getInstance() {
+  if (!_instance) {
+    _instance = new InputRecorder();
+  }
+  return _instance;
+}
+
+InputRecorder::InputRecorder()
+    : _mode(Mode::NONE),
+      _isRecordingRequested(),
+      _isBenchmarkMode(),
+      _replayFileName(),
+      _seed(),
+      _tmxMapFileName(),
+      _keyEvents(),
+      _nextKeyEvent(),
+      _tick(),
+      _numTicks() {}
+
+
+void InputRecorder::requestRecording(const string& replayFileName) {
+  _isRecordingRequested = true;
+  _replayFileName = replayFileName;
+}
+
+void InputRecorder::loadReplay(const string& replayFileName, bool isBenchmarkMode) {
+  ifstream fin(replayFileName);
+  if (!fin.is_open()) {
+    throw runtime_error("Failed to open replay: " + replayFileName);
+  }
+
+  string line;
+  if (!std::getline(fin, line) || line != _kFileHeader) {
+    throw runtime_error("Not a replay file: " + replayFileName);
+  }
+
+  _keyEvents.clear();
+  bool hasEnd = false;
+
+  while (std::getline(fin, line)) {
+    istringstream iss(line);
+    string field;
+    iss >> field;
+
+    if (field == "seed") {
+      iss >> _seed;
+    } else if (field == "map") {
+      iss >> _tmxMapFileName;
+    } else if (field == "end") {
+      iss >> _numTicks;
+      hasEnd = true;
+    } else if (!field.empty()) {
+      string type;
+      int keyCode;
+      iss >> type >> keyCode;
+      if (iss.fail() || (type != "p" && type != "r")) {
+        throw runtime_error("Malformed replay record: " + line);
+      }
+      uint32_t tick = std::stoul(field);
+      _keyEvents.push_back({tick, static_cast<EventKeyboard::KeyCode>(keyCode), type == "p"});
+    }
+  }
+
+  if (!hasEnd || _tmxMapFileName.empty()) {
+    throw runtime_error("Truncated replay: " + replayFileName);
+  }
+
+  _mode = Mode::REPLAYING;
+  _isBenchmarkMode = isBenchmarkMode;
+  _replayFileName = replayFileName;
+  _nextKeyEvent = 0;
+  _tick = 0;
+  VGLOG(LOG_INFO, "Loaded replay %s (%u ticks)", replayFileName.c_str(), _numTicks);
+}
+
+
+void InputRecorder::beginSession(unsigned int seed, const string& tmxMapFileName, bool isNewGame) {
+  if (!_isRecordingRequested) {
+    return;
+  }
+  if (!isNewGame) {
+    VGLOG(LOG_WARN, "Not recording %s: the session continues from a save, but replays start a new game",
+          _replayFileName.c_str());
+    _isRecordingRequested = false;
+    return;
+  }
+  _mode = Mode::RECORDING;
+  _seed = seed;
+  _tmxMapFileName = tmxMapFileName;
+  _keyEvents.clear();
+  _tick = 0;
+}
+
+void InputRecorder::endSession() {
+  if (_mode != Mode::RECORDING) {
+    return;
+  }
+  _mode = Mode::NONE;
+
+  ofstream fout(_replayFileName);
+  if (!fout.is_open()) {
+    VGLOG(LOG_ERR, "Failed to write replay: %s", _replayFileName.c_str());
+    return;
+  }
+
+  fout << _kFileHeader << '\n';
+  fout << "seed " << _seed << '\n';
+  fout << "map " << _tmxMapFileName << '\n';
+  for (const auto& e : _keyEvents) {
+    fout << e.tick << ((e.isPressed) ? " p " : " r ") << static_cast<int>(e.keyCode) << '\n';
+  }
+  fout << "end " << _tick << '\n';
+  VGLOG(LOG_INFO, "Recorded %u ticks to %s", _tick, _replayFileName.c_str());
+}
+
+
+void InputRecorder::recordKeyEvent(EventKeyboard::KeyCode keyCode, bool isPressed) {
+  if (_mode == Mode::RECORDING) {
+    _keyEvents.push_back({_tick, keyCode, isPressed});
+  }
+}
+
+void InputRecorder::replayKeyEvents() {
+  InputManager* inputMgr = InputManager::getInstance();
+
+  for (; _nextKeyEvent < _keyEvents.size() && _keyEvents[_nextKeyEvent].tick <= _tick; _nextKeyEvent++) {
+    const KeyEvent& e = _keyEvents[_nextKeyEvent];
+    if (e.isPressed) {
+      inputMgr->pressKey(e.keyCode);
+    } else {
+      inputMgr->releaseKey(e.keyCode);
+    }
+  }
+}
+
+void InputRecorder::stopReplay() {
+  if (_mode == Mode::REPLAYING) {
+    _mode = Mode::NONE;
+  }
+}
+
+void InputRecorder::nextTick() {
+  if (_mode != Mode::NONE) {
+    _tick++;
+  }
+}
+
+
+bool InputRecorder::isRecording() const {
+  return _mode == Mode::RECORDING;
+}
+
+bool InputRecorder::isReplaying() const {
+  return _mode == Mode::REPLAYING;
+}
+
+bool InputRecorder::isFixedStep() const {
+  return _mode != Mode::NONE;
+}
+
+bool InputRecorder::isBenchmarkMode() const {
+  return _mode == Mode::REPLAYING && _isBenchmarkMode;
+}
+
+bool InputRecorder::hasFinishedReplay() const {
+  return _mode == Mode::REPLAYING && _tick >= _numTicks;
+}
+
+
+unsigned int InputRecorder::getSeed() const {
+  return _seed;
+}
+
+const string& InputRecorder::getTmxMapFileName() const {
+  return _tmxMapFileName;
+}
+
+uint32_t InputRecorder::getTick() const {
+  return _tick;
+}
+
+} // namespace vigilante
@@ -0,0 +1,92 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_INPUT_RECORDER_H_
+#define VIGILANTE_INPUT_RECORDER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <cocos2d.h>
+
+namespace vigilante {
+
+// InputRecorder records the keyboard events of a game session per simulation
+// tick, together with the RNG seed and the starting map, and plays them back.
+//
+// While recording or replaying, MainGameScene advances the game with a fixed
+// delta (1 / kFps) per tick, so a replay drives the game exactly the same way
+// as the recorded session.
+//
+// Replay file format (text, one record per line):
+//   vigilante-replay 1
+//   seed <seed>
+//   map <tmxMapFileName>
+//   <tick> <p|r> <keyCode>    (p: pressed, r: released)
+//   ...
+//   end <numTicks>
+class InputRecorder {
+ public:
+  static InputRecorder* getInstance();
+  virtual ~InputRecorder() = default;
+
+  // These are set up from the command line before the game starts.
+  void requestRecording(const std::string& replayFileName);
+  void loadReplay(const std::string& replayFileName, bool isBenchmarkMode);
+
+  // Called by MainGameScene when the game starts. Starts recording if requested.
+  // Replays always start a new game, so a session continued from a save isn't recorded.
+  void beginSession(unsigned int seed, const std::string& tmxMapFileName, bool isNewGame);
+  // Writes the recorded session (if any) to the replay file.
+  void endSession();
+
+  void recordKeyEvent(cocos2d::EventKeyboard::KeyCode keyCode, bool isPressed);
+  // Feeds the recorded key events of the current tick to InputManager.
+  void replayKeyEvents();
+  void stopReplay();
+  void nextTick();
+
+  bool isRecording() const;
+  bool isReplaying() const;
+  bool isFixedStep() const; // is the game advanced with a fixed delta per tick?
+  bool isBenchmarkMode() const;
+  bool hasFinishedReplay() const;
+
+  unsigned int getSeed() const;
+  const std::string& getTmxMapFileName() const;
+  uint32_t getTick() const;
+
+ private:
+  static InputRecorder* _instance;
+  InputRecorder();
+
+  static const std::string _kFileHeader;
+
+  enum Mode {
+    NONE,
+    RECORDING,
+    REPLAYING
+  };
+
+  struct KeyEvent {
+    uint32_t tick;
+    cocos2d::EventKeyboard::KeyCode keyCode;
+    bool isPressed;
+  };
+
+  InputRecorder::Mode _mode;
+  bool _isRecordingRequested;
+  bool _isBenchmarkMode;
+  std::string _replayFileName;
+
+  unsigned int _seed;
+  std::string _tmxMapFileName;
+
+  std::vector<InputRecorder::KeyEvent> _keyEvents; // sorted by tick
+  size_t _nextKeyEvent; // the next event to replay
+  uint32_t _tick;
+  uint32_t _numTicks; // the length of the replay
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_INPUT_RECORDER_H_
@@ -4,7 +4,6 @@
 #include "util/JsonUtil.h"
 
 using std::string;
-using cocos2d::EventKeyboard; 
 using rapidjson::Document;
 
 namespace vigilante {
@@ -13,26 +12,12 @@ Consumable::Consumable(const string& jsonFileName)
     : Item(jsonFileName),
       _consumableProfile(jsonFileName) {}
 
-
-void Consumable::import(const string& jsonFileName) {
-  Item::import(jsonFileName);
-  _consumableProfile = Consumable::Profile(jsonFileName);
-}
-
-EventKeyboard::KeyCode Consumable::getHotkey() const {
-  return _consumableProfile.hotkey;
-}
-
-void Consumable::setHotkey(EventKeyboard::KeyCode hotkey) {
-  _consumableProfile.hotkey = hotkey;
-}
-
-Consumable::Profile& Consumable::getConsumableProfile() {
+const Consumable::Profile& Consumable::getConsumableProfile() const {
   return _consumableProfile;
 }
 
 
-Consumable::Profile::Profile(const string& jsonFileName) : hotkey(){
+Consumable::Profile::Profile(const string& jsonFileName) {
   Document json = json_util::parseJson(jsonFileName);
 
   duration = json["duration"].GetFloat();
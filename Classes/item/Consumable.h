@@ -4,13 +4,11 @@
 
 #include <string>
 
-#include <cocos2d.h>
 #include "item/Item.h"
-#include "input/Keybindable.h"
 
 namespace vigilante {
 
-class Consumable : public Item, public Keybindable {
+class Consumable : public Item {
  public:
   struct Profile {
     explicit Profile(const std::string& jsonFileName);
@@ -32,20 +30,18 @@ class Consumable : public Item, public Keybindable {
 
     int bonusMoveSpeed;
     int bonusJumpHeight;
-
-    cocos2d::EventKeyboard::KeyCode hotkey;
   };
 
-  explicit Consumable(const std::string& jsonFileName);
   virtual ~Consumable() = default;
-  virtual void import (const std::string& jsonFileName) override; // Importable
 
-  virtual cocos2d::EventKeyboard::KeyCode getHotkey() const override; // Keybindable
-  virtual void setHotkey(cocos2d::EventKeyboard::KeyCode hotkey) override; // Keybindable
+  // A consumable's hotkey belongs to the stack of it in its owner's inventory
+  // (see Character::ItemStack), since the consumable itself is shared.
+  const Consumable::Profile& getConsumableProfile() const;
 
-  Consumable::Profile& getConsumableProfile();
+ private:
+  friend class Item; // created by Item::getPrototype()
+  explicit Consumable(const std::string& jsonFileName);
 
- protected:
   Consumable::Profile _consumableProfile;
 };
 
@@ -24,12 +24,7 @@ Equipment::Equipment(const string& jsonFileName)
     : Item(jsonFileName),
       _equipmentProfile(jsonFileName) {}
 
-void Equipment::import(const string& jsonFileName) {
-  Item::import(jsonFileName);
-  _equipmentProfile = Equipment::Profile(jsonFileName);
-}
-
-Equipment::Profile& Equipment::getEquipmentProfile() {
+const Equipment::Profile& Equipment::getEquipmentProfile() const {
   return _equipmentProfile;
 }
 
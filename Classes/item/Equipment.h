@@ -41,13 +41,14 @@ class Equipment : public Item {
 
   static const std::array<std::string, Equipment::Type::SIZE> _kEquipmentTypeStr;
 
-  explicit Equipment(const std::string& jsonFileName);
   virtual ~Equipment() = default;
-  virtual void import(const std::string& jsonFileName) override; // Importable
 
-  Equipment::Profile& getEquipmentProfile();
+  const Equipment::Profile& getEquipmentProfile() const;
 
  private:
+  friend class Item; // created by Item::getPrototype()
+  explicit Equipment(const std::string& jsonFileName);
+
   Equipment::Profile _equipmentProfile;
 };
 
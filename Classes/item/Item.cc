@@ -2,27 +2,20 @@
 #include "Item.h"
 
 #include <json/document.h>
-#include "Constants.h"
 #include "item/Equipment.h"
 #include "item/Consumable.h"
 #include "item/MiscItem.h"
-#include "map/GameMapManager.h"
-#include "util/box2d/b2BodyBuilder.h"
 #include "util/JsonUtil.h"
 
 using std::string;
-using cocos2d::Sprite;
-using vigilante::category_bits::kItem;
-using vigilante::category_bits::kFeet;
-using vigilante::category_bits::kWall;
-using vigilante::category_bits::kGround;
-using vigilante::category_bits::kPlatform;
+using std::unique_ptr;
 using rapidjson::Document;
 
 namespace vigilante {
 
-const int Item::_kNumAnimations = 0;
-const int Item::_kNumFixtures = 2;
+AtomMap<unique_ptr<Item>> Item::_prototypes;
+AtomMap<const Item*> Item::_prototypesByName;
+int Item::_numPrototypes = 0;
 
 Item* Item::create(const string& jsonFileName) {
   if (jsonFileName.find("equipment") != jsonFileName.npos) {
@@ -34,59 +27,29 @@ Item* Item::create(const string& jsonFileName) {
   }
 }
 
-Item::Item(const string& jsonFileName)
-    : DynamicActor(_kNumAnimations, _kNumFixtures),
-      _itemProfile(jsonFileName),
-      _amount(1) {
-  _bodySprite = Sprite::create(getIconPath());
-  _bodySprite->getTexture()->setAliasTexParameters();
-}
-
+const Item* Item::getPrototype(const string& jsonFileName) {
+  unique_ptr<Item>& prototype = _prototypes[Atom(jsonFileName)];
+  if (!prototype) {
+    prototype = unique_ptr<Item>(create(jsonFileName));
+    prototype->_id = _numPrototypes++;
 
-void Item::showOnMap(float x, float y) {
-  if (_isShownOnMap) {
-    return;
+    const Item*& prototypeByName = _prototypesByName[prototype->_itemProfile.nameAtom];
+    if (!prototypeByName) {
+      prototypeByName = prototype.get();
+    }
   }
-  _isShownOnMap = true;
-  GameMapManager::getInstance()->getGameMap()->getDynamicActors().insert(this);
-
-  short categoryBits = kItem;
-  short maskBits = kGround | kPlatform | kWall;
-  defineBody(b2BodyType::b2_dynamicBody, categoryBits, maskBits, x, y);  
-
-  _bodySprite = Sprite::create(getIconPath());
-  _bodySprite->getTexture()->setAliasTexParameters();
-  GameMapManager::getInstance()->getLayer()->addChild(_bodySprite, 33);
+  return prototype.get();
 }
 
-void Item::import(const string& jsonFileName) {
-  _itemProfile = Item::Profile(jsonFileName);
+const Item* Item::getPrototypeByName(Atom name) {
+  const Item* const* prototype = _prototypesByName.find(name);
+  return (prototype) ? *prototype : nullptr;
 }
 
+Item::Item(const string& jsonFileName) : _itemProfile(jsonFileName), _id(-1) {}
 
-void Item::defineBody(b2BodyType bodyType, short categoryBits, short maskBits, float x, float y) {
-  b2BodyBuilder bodyBuilder(GameMapManager::getInstance()->getWorld());
-
-  _body = bodyBuilder.type(bodyType)
-    .position(x, y, kPpm)
-    .buildBody();
-
-  bodyBuilder.newRectangleFixture(kIconSize / 2, kIconSize / 2, kPpm)
-    .categoryBits(categoryBits)
-    .maskBits(maskBits | kFeet) // Enable collision detection with feet fixtures
-    .setSensor(true)
-    .setUserData(this)
-    .buildFixture();
 
-  bodyBuilder.newRectangleFixture(kIconSize / 2, kIconSize / 2, kPpm)
-    .categoryBits(categoryBits)
-    .maskBits(maskBits)
-    .setUserData(this)
-    .buildFixture();
-}
-
-
-Item::Profile& Item::getItemProfile() {
+const Item::Profile& Item::getItemProfile() const {
   return _itemProfile;
 }
 
@@ -102,13 +65,8 @@ string Item::getIconPath() const {
   return _itemProfile.textureResDir + "/icon.png";
 }
 
-
-int Item::getAmount() const {
-  return _amount;
-}
-
-void Item::setAmount(int amount) {
-  _amount = amount;
+int Item::getId() const {
+  return _id;
 }
 
 
@@ -117,7 +75,9 @@ Item::Profile::Profile(const string& jsonFileName) : jsonFileName(jsonFileName)
 
   itemType = static_cast<Item::Type>(json["itemType"].GetInt());
   textureResDir = json["textureResDir"].GetString();
+  textureResDirAtom = Atom(textureResDir);
   name = json["name"].GetString();
+  nameAtom = Atom(name);
   desc = json["desc"].GetString();
 }
 
@@ -2,16 +2,17 @@
 #ifndef VIGILANTE_ITEM_H_
 #define VIGILANTE_ITEM_H_
 
+#include <memory>
 #include <string>
 
-#include <cocos2d.h>
-#include <Box2D/Box2D.h>
-#include "DynamicActor.h"
-#include "Importable.h"
+#include "util/Atom.h"
 
 namespace vigilante {
 
-class Item : public DynamicActor, public Importable {
+// An Item is a kind of item (e.g., a short sword) rather than a single one.
+// Each kind is loaded once, and shared by every inventory holding some of it
+// (see Character::ItemStack) and every WorldItem of it lying on the map.
+class Item {
  public:
   enum Type {
     EQUIPMENT,
@@ -27,35 +28,41 @@ class Item : public DynamicActor, public Importable {
     std::string jsonFileName;
     Item::Type itemType;
     std::string textureResDir;
+    Atom textureResDirAtom; // for lookups
     std::string name;
+    Atom nameAtom; // for lookups
     std::string desc;
   };
 
-  // Create an item by automatically deducing its concrete type
-  // based on the json passed in.
-  static Item* create(const std::string& jsonFileName);
+  // Returns the item loaded from jsonFileName, loading it first if needed.
+  // Its concrete type is deduced from jsonFileName. Items are never destroyed.
+  static const Item* getPrototype(const std::string& jsonFileName);
+  // Returns nullptr if no item with this name has been loaded yet.
+  static const Item* getPrototypeByName(Atom name);
 
   virtual ~Item() = default;
-  virtual void showOnMap(float x, float y) override; // DynamicActor
-  virtual void import(const std::string& jsonFileName) override; // Importable
 
-  Item::Profile& getItemProfile();
+  const Item::Profile& getItemProfile() const;
   const std::string& getName() const;
   const std::string& getDesc() const;
   std::string getIconPath() const;
 
-  int getAmount() const;
-  void setAmount(int amount);
+  // Items are numbered from 0 in the order they're loaded,
+  // so the id can index a flat array (see Character::getItemStack()).
+  int getId() const;
 
  protected:
   explicit Item(const std::string& jsonFileName);
-  void defineBody(b2BodyType bodyType, short categoryBits, short maskBits, float x, float y);
-
-  static const int _kNumAnimations;
-  static const int _kNumFixtures;
 
   Item::Profile _itemProfile;
-  int _amount;
+  int _id;
+
+ private:
+  static Item* create(const std::string& jsonFileName);
+
+  static AtomMap<std::unique_ptr<Item>> _prototypes; // keyed by jsonFileName
+  static AtomMap<const Item*> _prototypesByName;
+  static int _numPrototypes;
 };
 
 } // namespace vigilante
@@ -10,8 +10,11 @@ namespace vigilante {
 
 class MiscItem : public Item {
  public:
-  explicit MiscItem(const std::string& jsonFileName);
   virtual ~MiscItem() = default;
+
+ private:
+  friend class Item; // created by Item::getPrototype()
+  explicit MiscItem(const std::string& jsonFileName);
 };
 
 } // namespace vigilante
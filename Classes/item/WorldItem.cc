@@ -0,0 +1,70 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "WorldItem.h"
+
+#include "Constants.h"
+#include "map/GameMapManager.h"
+#include "util/box2d/b2BodyBuilder.h"
+
+using cocos2d::Sprite;
+using vigilante::category_bits::kItem;
+using vigilante::category_bits::kWall;
+using vigilante::category_bits::kGround;
+using vigilante::category_bits::kPlatform;
+
+namespace vigilante {
+
+const int WorldItem::_kNumAnimations = 0;
+const int WorldItem::_kNumFixtures = 1;
+
+WorldItem::WorldItem(const Item* item, int amount)
+    : DynamicActor(_kNumAnimations, _kNumFixtures),
+      _item(item),
+      _amount(amount) {}
+
+
+void WorldItem::showOnMap(float x, float y) {
+  if (_isShownOnMap) {
+    return;
+  }
+  _isShownOnMap = true;
+  GameMapManager::getInstance()->getGameMap()->getDynamicActors().insert(this);
+
+  short categoryBits = kItem;
+  short maskBits = kGround | kPlatform | kWall;
+  defineBody(b2BodyType::b2_dynamicBody, categoryBits, maskBits, x, y);  
+
+  _bodySprite = Sprite::create(_item->getIconPath());
+  _bodySprite->getTexture()->setAliasTexParameters();
+  GameMapManager::getInstance()->getLayer()->addChild(_bodySprite, 33);
+}
+
+void WorldItem::update(float delta) {
+  DynamicActor::update(delta);
+  GameMapManager::getInstance()->getGameMap()->getSpatialHash().update(this, kItem);
+}
+
+
+void WorldItem::defineBody(b2BodyType bodyType, short categoryBits, short maskBits, float x, float y) {
+  b2BodyBuilder bodyBuilder(GameMapManager::getInstance()->getWorld());
+
+  _body = bodyBuilder.type(bodyType)
+    .position(x, y, kPpm)
+    .buildBody();
+
+  bodyBuilder.newRectangleFixture(kIconSize / 2, kIconSize / 2, kPpm)
+    .categoryBits(categoryBits)
+    .maskBits(maskBits)
+    .setUserData(this)
+    .buildFixture();
+}
+
+
+const Item* WorldItem::getItem() const {
+  return _item;
+}
+
+int WorldItem::getAmount() const {
+  return _amount;
+}
+
+} // namespace vigilante
@@ -0,0 +1,36 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_WORLD_ITEM_H_
+#define VIGILANTE_WORLD_ITEM_H_
+
+#include <Box2D/Box2D.h>
+#include "DynamicActor.h"
+#include "item/Item.h"
+
+namespace vigilante {
+
+// A pile of items lying on the map, which characters can pick up.
+// Only these are actors. Once picked up, items are just a Character::ItemStack,
+// and a WorldItem is created again only when they are dropped (see GameMap::spawnItem()).
+class WorldItem : public DynamicActor {
+ public:
+  WorldItem(const Item* item, int amount);
+  virtual ~WorldItem() = default;
+  virtual void showOnMap(float x, float y) override; // DynamicActor
+  virtual void update(float delta) override; // DynamicActor
+
+  const Item* getItem() const;
+  int getAmount() const;
+
+ private:
+  void defineBody(b2BodyType bodyType, short categoryBits, short maskBits, float x, float y);
+
+  static const int _kNumAnimations;
+  static const int _kNumFixtures;
+
+  const Item* _item;
+  int _amount;
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_WORLD_ITEM_H_
@@ -4,7 +4,6 @@
 #include "Constants.h"
 #include "StaticActor.h"
 
-using std::string;
 using cocos2d::FileUtils;
 using cocos2d::Layer;
 using cocos2d::Vector;
@@ -25,8 +24,7 @@ namespace vigilante {
 FxManager::FxManager(Layer* gameMapLayer) : _gameMapLayer(gameMapLayer) {}
 
 
-void FxManager::createFx(const string& textureResDir, const string& framesName,
-                         float x, float y) {
+void FxManager::createFx(Atom textureResDir, Atom framesName, float x, float y) {
   // If the cocos2d::Animation* is not present in cache, then create one
   // and cache this animation object.
   //
@@ -34,38 +32,29 @@ void FxManager::createFx(const string& textureResDir, const string& framesName,
   // |_____________| |__||____|
   //  textureResDir    |  framesName
   //            framesNamePrefix
-  string framesNamePrefix = StaticActor::getLastDirName(textureResDir);
-  string cacheKey = textureResDir + "/" + framesNamePrefix + "_" + framesName;
-
-  if (_animationCache.find(cacheKey) == _animationCache.end()) {
-    Animation* animation = StaticActor::createAnimation(textureResDir, framesName, 10.0f / kPpm);
-    _animationCache.insert({cacheKey, animation});
+  Animation*& animation = _animationCache[{textureResDir, framesName}];
+  if (!animation) {
+    animation = StaticActor::createAnimation(textureResDir.str(), framesName.str(), 10.0f / kPpm);
   }
 
   // Select the first frame (e.g., dust_white/0.png) as the default look of the sprite.
-  Sprite* sprite = Sprite::createWithSpriteFrameName(framesNamePrefix + "_" + framesName + "/0.png");
+  // Its texture is the spritesheet (e.g., Texture/fx/dust/spritesheet.png).
+  SpriteFrame* firstFrame = animation->getFrames().front()->getSpriteFrame();
+  Sprite* sprite = Sprite::createWithSpriteFrame(firstFrame);
   sprite->setPosition(x, y);
 
-  string spritesheetFileName = FxManager::getSpritesheetFileName(textureResDir);
-  SpriteBatchNode* spritesheet = SpriteBatchNode::create(spritesheetFileName);
+  SpriteBatchNode* spritesheet = SpriteBatchNode::createWithTexture(firstFrame->getTexture());
   spritesheet->addChild(sprite);
   spritesheet->getTexture()->setAliasTexParameters();
   _gameMapLayer->addChild(spritesheet, 80);
 
   // Run animation.
   FiniteTimeAction* animate = nullptr;
-  animate = Repeat::create(Animate::create(_animationCache[cacheKey]), 1);
+  animate = Repeat::create(Animate::create(animation), 1);
   auto cleanup = CallFunc::create([=]() {
     _gameMapLayer->removeChild(spritesheet);
   });
   sprite->runAction(Sequence::createWithTwoActions(animate, cleanup));
 }
 
-string FxManager::getSpritesheetFileName(const string& textureResDir) {
-  // Example: Texture/fx/dust/spritesheet.png
-  //          |_____________| |_____________|
-  //           textureResDir
-  return textureResDir + "/spritesheet.png";
-}
-
 } // namespace vigilante
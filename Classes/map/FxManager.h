@@ -2,10 +2,10 @@
 #ifndef VIGILANTE_FX_MANAGER_H_
 #define VIGILANTE_FX_MANAGER_H_
 
-#include <unordered_map>
-#include <string>
+#include <utility>
 
 #include <cocos2d.h>
+#include "util/Atom.h"
 
 namespace vigilante {
 
@@ -14,14 +14,13 @@ class FxManager {
   explicit FxManager(cocos2d::Layer* gameMapLayer);
   virtual ~FxManager() = default;
 
-  void createFx(const std::string& textureResDir, const std::string& framesName,
-                float x, float y);
+  void createFx(Atom textureResDir, Atom framesName, float x, float y);
 
  private:
-  static std::string getSpritesheetFileName(const std::string& textureResDir);
-
   cocos2d::Layer* _gameMapLayer;
-  std::unordered_map<std::string, cocos2d::Animation*> _animationCache;
+  // Keyed by (textureResDir, framesName). The first frame of each
+  // animation is used as the default look of the sprite.
+  FlatMap<std::pair<Atom, Atom>, cocos2d::Animation*> _animationCache;
 };
 
 } // namespace vigilante
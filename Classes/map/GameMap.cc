@@ -7,6 +7,8 @@
 #include "character/Player.h"
 #include "character/Enemy.h"
 #include "character/Npc.h"
+#include "gameplay/AutoSave.h"
+#include "input/InputRecorder.h"
 #include "item/Equipment.h"
 #include "item/Consumable.h"
 #include "map/GameMapManager.h"
@@ -23,6 +25,7 @@ using std::unique_ptr;
 using cocos2d::Director;
 using cocos2d::TMXTiledMap;
 using cocos2d::TMXObjectGroup;
+using cocos2d::ValueMap;
 using cocos2d::Sequence;
 using cocos2d::FadeIn;
 using cocos2d::FadeOut;
@@ -33,6 +36,10 @@ namespace vigilante {
 GameMap::GameMap(b2World* world, const string& tmxMapFileName)
     : _world(world),
       _tmxTiledMap(TMXTiledMap::create(tmxMapFileName)),
+      _tmxMapFileName(tmxMapFileName),
+      _navGraph(),
+      _occupancyGrid(),
+      _spatialHash(),
       _dynamicActors(),
       _portals() {}
 
@@ -42,7 +49,8 @@ void GameMap::createObjects() {
   createPolylines("Ground", category_bits::kGround, true, kGroundFriction);
   createPolylines("Wall", category_bits::kWall, true, kWallFriction);
   createRectangles("Platform", category_bits::kPlatform, true, kGroundFriction);
-  createPolylines("CliffMarker", category_bits::kCliffMarker, false, 0);
+  _navGraph.build(_tmxTiledMap);
+  _occupancyGrid.build(_tmxTiledMap);
   createPortals();
   createChests();
 
@@ -75,6 +83,22 @@ TMXTiledMap* GameMap::getTmxTiledMap() const {
   return _tmxTiledMap;
 }
 
+const string& GameMap::getTmxMapFileName() const {
+  return _tmxMapFileName;
+}
+
+NavGraph& GameMap::getNavGraph() {
+  return _navGraph;
+}
+
+const OccupancyGrid& GameMap::getOccupancyGrid() const {
+  return _occupancyGrid;
+}
+
+SpatialHash& GameMap::getSpatialHash() {
+  return _spatialHash;
+}
+
 
 unordered_set<DynamicActor*>& GameMap::getDynamicActors() {
   return _dynamicActors;
@@ -92,6 +116,20 @@ float GameMap::getHeight() const {
   return _tmxTiledMap->getMapSize().height * _tmxTiledMap->getTileSize().height;
 }
 
+vector<b2Vec2> GameMap::getPolylineVertices(const ValueMap& valMap) {
+  float scaleFactor = Director::getInstance()->getContentScaleFactor();
+  float xRef = valMap.at("x").asFloat();
+  float yRef = valMap.at("y").asFloat();
+
+  vector<b2Vec2> vertices;
+  for (auto& point : valMap.at("polylinePoints").asValueVector()) {
+    float x = point.asValueMap().at("x").asFloat() / scaleFactor;
+    float y = point.asValueMap().at("y").asFloat() / scaleFactor;
+    vertices.push_back({xRef + x, yRef - y});
+  }
+  return vertices;
+}
+
 
 Player* GameMap::createPlayer() const {
   TMXObjectGroup* objGroup = _tmxTiledMap->getObjectGroup("Player");
@@ -103,12 +141,11 @@ Player* GameMap::createPlayer() const {
   return player;
 }
 
-Item* GameMap::spawnItem(const string& itemJson, float x, float y, int amount) {
-  Item* item = Item::create(itemJson);
-  item->setAmount(amount);
+WorldItem* GameMap::spawnItem(const string& itemJson, float x, float y, int amount) {
+  WorldItem* item = new WorldItem(Item::getPrototype(itemJson), amount);
   item->showOnMap(x, y);
 
-  float offsetX = rand_util::randFloat(-.3f, .3f);
+  float offsetX = rand_util::randFloat(-.3f, .3f, rand_util::Stream::LOOT);
   float offsetY = 3.0f;
   item->getBody()->ApplyLinearImpulse({offsetX, offsetY}, item->getBody()->GetWorldCenter(), true);
 
@@ -144,20 +181,8 @@ void GameMap::createRectangles(const string& layerName, short categoryBits, bool
 }
 
 void GameMap::createPolylines(const string& layerName, short categoryBits, bool collidable, float friction) {
-  float scaleFactor = Director::getInstance()->getContentScaleFactor();
-
   for (auto& lineObj : _tmxTiledMap->getObjectGroup(layerName)->getObjects()) {
-    auto& valMap = lineObj.asValueMap();
-    float xRef = valMap["x"].asFloat();
-    float yRef = valMap["y"].asFloat();
-
-    auto& valVec = valMap["polylinePoints"].asValueVector();
-    b2Vec2 vertices[valVec.size()];
-    for (size_t i = 0; i < valVec.size(); i++) {
-      float x = valVec[i].asValueMap()["x"].asFloat() / scaleFactor;
-      float y = valVec[i].asValueMap()["y"].asFloat() / scaleFactor;
-      vertices[i] = {xRef + x, yRef - y};
-    }
+    vector<b2Vec2> vertices = getPolylineVertices(lineObj.asValueMap());
 
     b2BodyBuilder bodyBuilder(_world);
 
@@ -165,7 +190,7 @@ void GameMap::createPolylines(const string& layerName, short categoryBits, bool
       .position(0, 0, kPpm)
       .buildBody();
 
-    bodyBuilder.newPolylineFixture(vertices, valVec.size(), kPpm)
+    bodyBuilder.newPolylineFixture(vertices.data(), vertices.size(), kPpm)
       .categoryBits(categoryBits)
       .setSensor(!collidable)
       .friction(friction)
@@ -271,6 +296,11 @@ void GameMap::Portal::onInteract(Character* user) {
 
       auto pos = gmMgr->getGameMap()->getPortals().at(targetPortalId)->getBody()->GetPosition();
       user->setPosition(pos.x, pos.y);
+
+      // Autosave at every portal transition (but never during a replay).
+      if (user == gmMgr->getPlayer() && !InputRecorder::getInstance()->isReplaying()) {
+        AutoSave::getInstance()->save();
+      }
     }),
     FadeOut::create(Shade::_kFadeOutTime),
     nullptr
@@ -289,6 +319,11 @@ bool GameMap::Portal::willInteractOnContact() const {
   return _willInteractOnContact;
 }
 
+float GameMap::Portal::getInteractionRange() const {
+  // Portals are found through their own fixtures (see WorldContactListener).
+  return 0;
+}
+
 b2Body* GameMap::Portal::getBody() const {
   return _body;
 }
@@ -11,7 +11,10 @@
 #include <Box2D/Box2D.h>
 #include "DynamicActor.h"
 #include "Interactable.h"
-#include "item/Item.h"
+#include "NavGraph.h"
+#include "OccupancyGrid.h"
+#include "SpatialHash.h"
+#include "item/WorldItem.h"
 
 namespace vigilante {
 
@@ -26,6 +29,7 @@ class GameMap {
     virtual ~Portal();
     virtual void onInteract(Character* user) override; // Interactable
     virtual bool willInteractOnContact() const override; // Interactable
+    virtual float getInteractionRange() const override; // Interactable
 
     const std::string& getTargetTmxMapFileName() const;
     int getTargetPortalId() const;
@@ -46,16 +50,24 @@ class GameMap {
 
   std::unordered_set<b2Body*>& getTmxTiledMapBodies();
   cocos2d::TMXTiledMap* getTmxTiledMap() const;
+  const std::string& getTmxMapFileName() const;
+  NavGraph& getNavGraph();
+  const OccupancyGrid& getOccupancyGrid() const;
+  SpatialHash& getSpatialHash();
 
   std::unordered_set<DynamicActor*>& getDynamicActors();
   const std::vector<GameMap::Portal*>& getPortals() const;
 
   Player* createPlayer() const;
-  Item* spawnItem(const std::string& itemJson, float x, float y, int amount=1);
+  // Items are only actors while they're on the map. See WorldItem.
+  WorldItem* spawnItem(const std::string& itemJson, float x, float y, int amount=1);
 
   float getWidth() const;
   float getHeight() const;
 
+  // The vertices (in pixels) of a polyline object in a TMX object group.
+  static std::vector<b2Vec2> getPolylineVertices(const cocos2d::ValueMap& valMap);
+
  private:
   void createRectangles(const std::string& layerName, short categoryBits, bool collidable, float friction);
   void createPolylines(const std::string& layerName, short categoryBits, bool collidable, float friction);
@@ -67,6 +79,10 @@ class GameMap {
   b2World* _world;
   std::unordered_set<b2Body*> _tmxTiledMapBodies;
   cocos2d::TMXTiledMap* _tmxTiledMap;
+  std::string _tmxMapFileName;
+  NavGraph _navGraph;
+  OccupancyGrid _occupancyGrid;
+  SpatialHash _spatialHash;
 
   std::unordered_set<DynamicActor*> _dynamicActors;
   std::vector<GameMap::Portal*> _portals;
@@ -1,11 +1,14 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "GameMapManager.h"
 
+#include <algorithm>
+
 #include <Box2D/Box2D.h>
 #include "AssetManager.h"
 #include "Constants.h"
 #include "character/Player.h"
 #include "character/Enemy.h"
+#include "character/Bot.h"
 #include "item/Equipment.h"
 #include "skill/MagicalMissile.h"
 #include "util/box2d/b2BodyBuilder.h"
@@ -21,6 +24,8 @@ using cocos2d::TMXObjectGroup;
 namespace vigilante {
 
 GameMapManager* GameMapManager::_instance = nullptr;
+const Atom GameMapManager::_kDustFxTextureResDir("Texture/fx/dust");
+const Atom GameMapManager::_kDustFxFramesName("white");
 
 GameMapManager* GameMapManager::getInstance() {
   if (!_instance) {
@@ -33,21 +38,56 @@ GameMapManager::GameMapManager(const b2Vec2& gravity)
     : _layer(Layer::create()),
       _worldContactListener(new WorldContactListener()),
       _world(new b2World(gravity)),
+      _worldCommandBuffer(new WorldCommandBuffer()),
       _fxMgr(new FxManager(_layer)),
+      _animator(new Animator()),
+      _compositeAtlasCache(new CompositeAtlasCache()),
       _gameMap(),
-      _player() {
+      _player(),
+      _threadPool(new ThreadPool()),
+      _scheduledBots() {
   _world->SetAllowSleeping(true);
   _world->SetContinuousPhysics(true);
   _world->SetContactListener(_worldContactListener.get());
 }
 
 void GameMapManager::update(float delta) {
+  // Advance the animations of all actors in one pass.
+  _animator->update(delta);
+
   if (_player) {
     _player->update(delta);
   }
   for (auto actor : _gameMap->getDynamicActors()) {
     actor->update(delta);
   }
+
+  // Bots scheduled themselves during the updates above.
+  updateBots();
+}
+
+void GameMapManager::updateBots() {
+  if (_scheduledBots.empty()) {
+    return;
+  }
+
+  // Dynamic actors are stored by address, so sort the bots to make
+  // both the snapshots and the applied decisions deterministic.
+  std::sort(_scheduledBots.begin(), _scheduledBots.end(), [](Bot* b1, Bot* b2) {
+    return b1->getBotId() < b2->getBotId();
+  });
+
+  for (auto bot : _scheduledBots) {
+    bot->captureSnapshot();
+  }
+  _threadPool->parallelFor(_scheduledBots.size(), [this](size_t i) {
+    _scheduledBots[i]->decide();
+  });
+  for (auto bot : _scheduledBots) {
+    bot->applyDecision();
+  }
+
+  _scheduledBots.clear();
 }
 
 
@@ -58,9 +98,18 @@ GameMap* GameMapManager::getGameMap() const {
 void GameMapManager::loadGameMap(const string& tmxMapFileName) {
   // Clean up previous GameMap.
   if (_gameMap) {
+    // Apply pending world mutations while the actors they refer to are still alive.
+    _worldCommandBuffer->flush();
     _layer->removeChild(_gameMap->getTmxTiledMap());
     _gameMap->deleteObjects();
     _gameMap.reset(); // deletes the underlying GameMap object
+
+    // The atlases baked for the previous map are dropped, except that
+    // the player (which outlives GameMaps) rebakes its own right away.
+    _compositeAtlasCache->clear();
+    if (_player) {
+      _player->rebakeEquipmentAnimations();
+    }
   }
 
   _gameMap = unique_ptr<GameMap>(new GameMap(_world.get(), tmxMapFileName));
@@ -82,16 +131,32 @@ b2World* GameMapManager::getWorld() const {
   return _world.get();
 }
 
+WorldCommandBuffer* GameMapManager::getWorldCommandBuffer() const {
+  return _worldCommandBuffer.get();
+}
+
 Layer* GameMapManager::getLayer() const {
   return _layer;
 }
 
+Animator* GameMapManager::getAnimator() const {
+  return _animator.get();
+}
+
+CompositeAtlasCache* GameMapManager::getCompositeAtlasCache() const {
+  return _compositeAtlasCache.get();
+}
+
+
+void GameMapManager::scheduleBot(Bot* bot) {
+  _scheduledBots.push_back(bot);
+}
 
 void GameMapManager::createDustFx(Character* character) {
   auto feetPos = character->getBody()->GetPosition();
   float x = feetPos.x * kPpm;// - 32.f / kPpm / 2;
   float y = (feetPos.y - .1f) * kPpm;// - 32.f / kPpm / .065f;
-  _fxMgr->createFx("Texture/fx/dust", "white", x, y);
+  _fxMgr->createFx(_kDustFxTextureResDir, _kDustFxFramesName, x, y);
 }
 
 } // namespace vigilante
@@ -5,19 +5,25 @@
 #include <set>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include <cocos2d.h>
 #include <Box2D/Box2D.h>
+#include "Animator.h"
+#include "CompositeAtlasCache.h"
 #include "GameMap.h"
 #include "WorldContactListener.h"
+#include "WorldCommandBuffer.h"
 #include "FxManager.h"
 #include "Controllable.h"
 #include "character/Character.h"
 #include "item/Item.h"
+#include "util/ThreadPool.h"
 
 namespace vigilante {
 
 class Player;
+class Bot;
 
 class GameMapManager {
  public:
@@ -31,21 +37,38 @@ class GameMapManager {
 
   Player* getPlayer() const;
   b2World* getWorld() const;
+  WorldCommandBuffer* getWorldCommandBuffer() const;
 
   cocos2d::Layer* getLayer() const;
+  Animator* getAnimator() const;
+  CompositeAtlasCache* getCompositeAtlasCache() const;
 
   void createDustFx(Character* character);
 
+  // Runs the AI of this bot (see Bot.h) in the current frame's decision phase.
+  void scheduleBot(Bot* bot);
+
  private:
   static GameMapManager* _instance;
   explicit GameMapManager(const b2Vec2& gravity);
 
+  void updateBots();
+
+  static const Atom _kDustFxTextureResDir;
+  static const Atom _kDustFxFramesName;
+
   cocos2d::Layer* _layer;
   std::unique_ptr<WorldContactListener> _worldContactListener;
   std::unique_ptr<b2World> _world;
+  std::unique_ptr<WorldCommandBuffer> _worldCommandBuffer;
   std::unique_ptr<FxManager> _fxMgr;
+  std::unique_ptr<Animator> _animator;
+  std::unique_ptr<CompositeAtlasCache> _compositeAtlasCache;
   std::unique_ptr<GameMap> _gameMap;
   std::unique_ptr<Player> _player;
+
+  std::unique_ptr<ThreadPool> _threadPool;
+  std::vector<Bot*> _scheduledBots;
 };
 
 } // namespace vigilante
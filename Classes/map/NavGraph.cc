@@ -0,0 +1,339 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "NavGraph.h"
+
+#include <cmath>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <functional>
+
+#include "Constants.h"
+#include "map/GameMap.h"
+
+using std::pair;
+using std::vector;
+using std::string;
+using std::greater;
+using std::priority_queue;
+using std::numeric_limits;
+using cocos2d::TMXTiledMap;
+using cocos2d::ValueMap;
+
+namespace vigilante {
+
+const float NavGraph::_kMaxJumpHeight = 4.0f;
+const float NavGraph::_kMaxJumpDistance = 4.0f;
+
+namespace {
+
+// Two points closer than this are considered the same point.
+const float kEpsilon = .05f;
+// How far away from a span's edge a character falls off.
+const float kFallOffset = .1f;
+// How far above/below a span's surface a character's feet can be
+// while still being considered standing on it.
+const float kStandingTolerance = .15f;
+
+b2Vec2 getMidpoint(const NavGraph::Span& span) {
+  return {(span.left + span.right) / 2, (span.leftY + span.rightY) / 2};
+}
+
+float cross(const b2Vec2& o, const b2Vec2& a, const b2Vec2& b) {
+  return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+bool isIntersecting(const b2Vec2& p1, const b2Vec2& p2, const b2Vec2& q1, const b2Vec2& q2) {
+  float d1 = cross(q1, q2, p1);
+  float d2 = cross(q1, q2, p2);
+  float d3 = cross(p1, p2, q1);
+  float d4 = cross(p1, p2, q2);
+  return ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0));
+}
+
+} // namespace
+
+
+NavGraph::NavGraph() : _spans(), _edges(), _adjacentEdges(), _walls(), _pathCache() {}
+
+
+void NavGraph::build(TMXTiledMap* tmxTiledMap) {
+  _spans.clear();
+  _edges.clear();
+  _walls.clear();
+  _pathCache.clear();
+
+  createGroundSpans(tmxTiledMap, "Ground");
+  createPlatformSpans(tmxTiledMap, "Platform");
+  createWalls(tmxTiledMap, "Wall");
+  createEdges();
+}
+
+int NavGraph::findSpan(const b2Vec2& feetPos) const {
+  int result = -1;
+  float minDistance = kStandingTolerance;
+
+  for (size_t i = 0; i < _spans.size(); i++) {
+    const Span& span = _spans[i];
+    if (feetPos.x < span.left - kEpsilon || feetPos.x > span.right + kEpsilon) {
+      continue;
+    }
+    float distance = std::abs(feetPos.y - span.getY(feetPos.x));
+    if (distance <= minDistance) {
+      minDistance = distance;
+      result = i;
+    }
+  }
+  return result;
+}
+
+const NavGraph::Path* NavGraph::findPath(int from, int to, const NavGraph::Capability& capability) {
+  if (from < 0 || to < 0 || from >= (int) _spans.size() || to >= (int) _spans.size()) {
+    return nullptr;
+  }
+
+  uint64_t key = getPathCacheKey(from, to, capability);
+  auto it = _pathCache.find(key);
+  if (it != _pathCache.end()) {
+    return (it->second.empty()) ? nullptr : &(it->second);
+  }
+
+  // Quantized the same way as the cache key, so that every character
+  // sharing a cached path is able to follow it.
+  float maxJumpHeight = std::floor(capability.maxJumpHeight * 10) / 10;
+  float maxJumpDistance = std::floor(capability.maxJumpDistance * 10) / 10;
+
+  // A* over spans. The cost of an edge is at least the distance between
+  // the midpoints of its spans, so the straight-line distance is admissible.
+  b2Vec2 goal = getMidpoint(_spans[to]);
+  vector<float> costs(_spans.size(), numeric_limits<float>::max());
+  vector<int> cameFrom(_spans.size(), -1); // edge index
+  priority_queue<pair<float, int>, vector<pair<float, int>>, greater<pair<float, int>>> openSet;
+
+  costs[from] = 0;
+  openSet.push({(goal - getMidpoint(_spans[from])).Length(), from});
+
+  while (!openSet.empty()) {
+    int current = openSet.top().second;
+    float estimatedCost = openSet.top().first;
+    openSet.pop();
+
+    if (current == to) {
+      break;
+    }
+    if (estimatedCost - (goal - getMidpoint(_spans[current])).Length() > costs[current] + kEpsilon) {
+      continue; // stale entry
+    }
+
+    for (auto edgeIdx : _adjacentEdges[current]) {
+      const Edge& edge = _edges[edgeIdx];
+      if (edge.type == EdgeType::JUMP
+          && (edge.height > maxJumpHeight || edge.distance > maxJumpDistance)) {
+        continue;
+      }
+
+      float cost = costs[current] + edge.cost;
+      if (cost < costs[edge.to]) {
+        costs[edge.to] = cost;
+        cameFrom[edge.to] = edgeIdx;
+        openSet.push({cost + (goal - getMidpoint(_spans[edge.to])).Length(), edge.to});
+      }
+    }
+  }
+
+  Path& path = _pathCache[key];
+  if (cameFrom[to] < 0) {
+    return nullptr;
+  }
+  for (int span = to; span != from; span = _edges[cameFrom[span]].from) {
+    path.push_back(cameFrom[span]);
+  }
+  std::reverse(path.begin(), path.end());
+  return &path;
+}
+
+const NavGraph::Span& NavGraph::getSpan(int span) const {
+  return _spans[span];
+}
+
+const NavGraph::Edge& NavGraph::getEdge(int edge) const {
+  return _edges[edge];
+}
+
+
+void NavGraph::createGroundSpans(TMXTiledMap* tmxTiledMap, const string& layerName) {
+  for (auto& lineObj : tmxTiledMap->getObjectGroup(layerName)->getObjects()) {
+    vector<b2Vec2> vertices = getPolylineVertices(lineObj.asValueMap());
+
+    for (size_t i = 1; i < vertices.size(); i++) {
+      b2Vec2 v1 = vertices[i - 1];
+      b2Vec2 v2 = vertices[i];
+      if (v1.x > v2.x) {
+        std::swap(v1, v2);
+      }
+      // Steep segments are walls rather than slopes.
+      if (v2.x - v1.x < kEpsilon || std::abs(v2.y - v1.y) > v2.x - v1.x) {
+        _walls.push_back({v1, v2});
+        continue;
+      }
+      _spans.push_back({v1.x, v2.x, v1.y, v2.y, false});
+    }
+  }
+}
+
+void NavGraph::createPlatformSpans(TMXTiledMap* tmxTiledMap, const string& layerName) {
+  for (auto& rectObj : tmxTiledMap->getObjectGroup(layerName)->getObjects()) {
+    auto& valMap = rectObj.asValueMap();
+    float x = valMap["x"].asFloat() / kPpm;
+    float y = valMap["y"].asFloat() / kPpm;
+    float w = valMap["width"].asFloat() / kPpm;
+    float h = valMap["height"].asFloat() / kPpm;
+    _spans.push_back({x, x + w, y + h, y + h, true});
+  }
+}
+
+void NavGraph::createWalls(TMXTiledMap* tmxTiledMap, const string& layerName) {
+  for (auto& lineObj : tmxTiledMap->getObjectGroup(layerName)->getObjects()) {
+    vector<b2Vec2> vertices = getPolylineVertices(lineObj.asValueMap());
+    for (size_t i = 1; i < vertices.size(); i++) {
+      _walls.push_back({vertices[i - 1], vertices[i]});
+    }
+  }
+}
+
+void NavGraph::createEdges() {
+  _adjacentEdges.assign(_spans.size(), {});
+
+  for (int a = 0; a < (int) _spans.size(); a++) {
+    const Span& from = _spans[a];
+    bool isLeftConnected = false;
+    bool isRightConnected = false;
+
+    for (int b = 0; b < (int) _spans.size(); b++) {
+      if (a == b) {
+        continue;
+      }
+      const Span& to = _spans[b];
+
+      // Walk onto an adjacent span.
+      if (std::abs(from.right - to.left) < kEpsilon && std::abs(from.rightY - to.leftY) < kEpsilon) {
+        addEdge(a, b, EdgeType::WALK, from.right, 0, 0);
+        isRightConnected = true;
+        continue;
+      }
+      if (std::abs(from.left - to.right) < kEpsilon && std::abs(from.leftY - to.rightY) < kEpsilon) {
+        addEdge(a, b, EdgeType::WALK, from.left, 0, 0);
+        isLeftConnected = true;
+        continue;
+      }
+
+      float overlapLeft = std::max(from.left, to.left);
+      float overlapRight = std::min(from.right, to.right);
+
+      if (overlapLeft < overlapRight) {
+        float x = (overlapLeft + overlapRight) / 2;
+        float dy = to.getY(x) - from.getY(x);
+
+        if (dy < -kEpsilon && from.isPlatform && findLanding(x, from.getY(x), a) == b) {
+          // Drop through this platform onto the span right below it.
+          addEdge(a, b, EdgeType::DROP, x, 0, 0);
+        } else if (dy > kEpsilon && dy <= _kMaxJumpHeight && to.isPlatform && findLanding(x, to.getY(x), b) == a) {
+          // Jump up through the platform right above this span.
+          addEdge(a, b, EdgeType::JUMP, x, dy + kEpsilon, 0);
+        }
+        continue;
+      }
+
+      // Jump across the gap between two spans.
+      b2Vec2 takeoff = (to.left >= from.right) ? b2Vec2(from.right, from.rightY) : b2Vec2(from.left, from.leftY);
+      b2Vec2 landing = (to.left >= from.right) ? b2Vec2(to.left, to.leftY) : b2Vec2(to.right, to.rightY);
+      float distance = std::abs(landing.x - takeoff.x);
+      float height = std::max(landing.y - takeoff.y, 0.0f) + kEpsilon;
+      if (distance > _kMaxJumpDistance || height > _kMaxJumpHeight || landing.y - takeoff.y < -_kMaxJumpHeight) {
+        continue;
+      }
+      b2Vec2 apex = {(takeoff.x + landing.x) / 2, std::max(takeoff.y, landing.y) + kEpsilon};
+      if (isBlockedByWall(takeoff, apex) || isBlockedByWall(apex, landing)) {
+        continue;
+      }
+      addEdge(a, b, EdgeType::JUMP, takeoff.x, height, distance);
+    }
+
+    // Walk off the unconnected edges of this span.
+    if (!isLeftConnected) {
+      int landing = findLanding(from.left - kFallOffset, from.leftY, a);
+      if (landing >= 0) {
+        addEdge(a, landing, EdgeType::FALL, from.left - kFallOffset, 0, 0);
+      }
+    }
+    if (!isRightConnected) {
+      int landing = findLanding(from.right + kFallOffset, from.rightY, a);
+      if (landing >= 0) {
+        addEdge(a, landing, EdgeType::FALL, from.right + kFallOffset, 0, 0);
+      }
+    }
+  }
+}
+
+void NavGraph::addEdge(int from, int to, NavGraph::EdgeType type, float x, float height, float distance) {
+  static const float penalties[] = {0, .5f, .5f, 1.0f}; // WALK, FALL, DROP, JUMP
+  float cost = (getMidpoint(_spans[to]) - getMidpoint(_spans[from])).Length() + penalties[type];
+
+  _adjacentEdges[from].push_back(_edges.size());
+  _edges.push_back({from, to, type, x, height, distance, cost});
+}
+
+
+int NavGraph::findLanding(float x, float y, int excluded) const {
+  int result = -1;
+  float maxY = -numeric_limits<float>::max();
+
+  for (int i = 0; i < (int) _spans.size(); i++) {
+    const Span& span = _spans[i];
+    if (i == excluded || x < span.left || x > span.right) {
+      continue;
+    }
+    float spanY = span.getY(x);
+    if (spanY < y - kEpsilon && spanY > maxY) {
+      maxY = spanY;
+      result = i;
+    }
+  }
+  return result;
+}
+
+bool NavGraph::isBlockedByWall(const b2Vec2& p1, const b2Vec2& p2) const {
+  for (const auto& wall : _walls) {
+    if (isIntersecting(p1, p2, wall.first, wall.second)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+vector<b2Vec2> NavGraph::getPolylineVertices(const ValueMap& valMap) {
+  vector<b2Vec2> vertices = GameMap::getPolylineVertices(valMap);
+  for (auto& vertex : vertices) {
+    vertex *= 1 / kPpm;
+  }
+  return vertices;
+}
+
+uint64_t NavGraph::getPathCacheKey(int from, int to, const NavGraph::Capability& capability) {
+  // Capabilities are quantized to 0.1m (up to 25.5m), so that characters
+  // of the same kind share the same cached paths.
+  uint64_t height = std::min(static_cast<int>(capability.maxJumpHeight * 10), 255);
+  uint64_t distance = std::min(static_cast<int>(capability.maxJumpDistance * 10), 255);
+  return (static_cast<uint64_t>(from) << 40) | (static_cast<uint64_t>(to) << 16) | (height << 8) | distance;
+}
+
+
+float NavGraph::Span::getY(float x) const {
+  if (right - left < kEpsilon) {
+    return leftY;
+  }
+  float t = std::min(std::max((x - left) / (right - left), 0.0f), 1.0f);
+  return leftY + (rightY - leftY) * t;
+}
+
+} // namespace vigilante
@@ -0,0 +1,104 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_NAV_GRAPH_H_
+#define VIGILANTE_NAV_GRAPH_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <cocos2d.h>
+#include <Box2D/Box2D.h>
+
+namespace vigilante {
+
+// NavGraph is the platform navigation graph of a GameMap.
+//
+// It is built once at map load from the TMX Ground/Platform/Wall geometry.
+// Each node (span) is a walkable surface, and each edge describes how a
+// character gets from one span to another (walk, fall, drop through or jump).
+// Paths are searched with A* and cached per map, so bots chasing the same
+// target across the same spans share the result.
+//
+// All coordinates are in box2d units (meters).
+class NavGraph {
+ public:
+  struct Span {
+    float getY(float x) const;
+
+    float left;
+    float right;
+    float leftY;
+    float rightY;
+    bool isPlatform; // can be dropped through with Character::jumpDown()
+  };
+
+  enum EdgeType {
+    WALK, // walk onto an adjacent span
+    FALL, // walk off the edge of a span
+    DROP, // drop through a platform
+    JUMP  // jump onto another span
+  };
+
+  struct Edge {
+    int from;
+    int to;
+    NavGraph::EdgeType type;
+    float x; // where the character should take off
+    float height; // the required jump height (JUMP only)
+    float distance; // the horizontal gap to cover (JUMP only)
+    float cost;
+  };
+
+  // The jumping capability of a character, see Bot::getNavCapability().
+  struct Capability {
+    float maxJumpHeight;
+    float maxJumpDistance;
+  };
+
+  using Path = std::vector<int>; // edge indices, from the start span to the goal span.
+
+  NavGraph();
+  virtual ~NavGraph() = default;
+
+  void build(cocos2d::TMXTiledMap* tmxTiledMap);
+
+  // Returns the index of the span on which feetPos stands, or -1 if none.
+  int findSpan(const b2Vec2& feetPos) const;
+
+  // Returns nullptr if there's no path from `from` to `to` for this capability.
+  const NavGraph::Path* findPath(int from, int to, const NavGraph::Capability& capability);
+
+  const NavGraph::Span& getSpan(int span) const;
+  const NavGraph::Edge& getEdge(int edge) const;
+
+ private:
+  void createGroundSpans(cocos2d::TMXTiledMap* tmxTiledMap, const std::string& layerName);
+  void createPlatformSpans(cocos2d::TMXTiledMap* tmxTiledMap, const std::string& layerName);
+  void createWalls(cocos2d::TMXTiledMap* tmxTiledMap, const std::string& layerName);
+  void createEdges();
+  void addEdge(int from, int to, NavGraph::EdgeType type, float x, float height, float distance);
+
+  // Returns the highest span at x whose surface is below y (excluding `excluded`), or -1 if none.
+  int findLanding(float x, float y, int excluded) const;
+  bool isBlockedByWall(const b2Vec2& p1, const b2Vec2& p2) const;
+
+  static std::vector<b2Vec2> getPolylineVertices(const cocos2d::ValueMap& valMap);
+  static uint64_t getPathCacheKey(int from, int to, const NavGraph::Capability& capability);
+
+  // Jump edges which exceed these are never created.
+  static const float _kMaxJumpHeight;
+  static const float _kMaxJumpDistance;
+
+  std::vector<NavGraph::Span> _spans;
+  std::vector<NavGraph::Edge> _edges;
+  std::vector<std::vector<int>> _adjacentEdges; // outgoing edges of each span
+  std::vector<std::pair<b2Vec2, b2Vec2>> _walls;
+
+  // An empty path means there's no path.
+  std::unordered_map<uint64_t, NavGraph::Path> _pathCache;
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_NAV_GRAPH_H_
@@ -0,0 +1,160 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "OccupancyGrid.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "Constants.h"
+#include "map/GameMap.h"
+
+using std::string;
+using std::vector;
+using std::numeric_limits;
+using cocos2d::TMXTiledMap;
+
+namespace vigilante {
+
+const float OccupancyGrid::_kSurfaceEpsilon = .001f;
+
+OccupancyGrid::OccupancyGrid() : _cellSize(1), _width(), _height(), _bits() {}
+
+
+void OccupancyGrid::build(TMXTiledMap* tmxTiledMap) {
+  _cellSize = tmxTiledMap->getTileSize().width / kPpm;
+  _width = tmxTiledMap->getMapSize().width;
+  _height = tmxTiledMap->getMapSize().height;
+  _bits.assign(Layer::LAYER_SIZE, vector<uint64_t>((_width * _height + 63) / 64));
+
+  rasterizePolylines(tmxTiledMap, "Ground");
+  rasterizePolylines(tmxTiledMap, "Wall");
+  rasterizePlatforms(tmxTiledMap, "Platform");
+}
+
+bool OccupancyGrid::hasLineOfSight(const b2Vec2& from, const b2Vec2& to) const {
+  // Amanatides & Woo's DDA: visit every cell the segment passes through.
+  int x = getCellCoord(from.x);
+  int y = getCellCoord(from.y);
+  int endX = getCellCoord(to.x);
+  int endY = getCellCoord(to.y);
+  if (x == endX && y == endY) {
+    return true;
+  }
+
+  b2Vec2 dir = to - from;
+  int stepX = (dir.x > 0) ? 1 : -1;
+  int stepY = (dir.y > 0) ? 1 : -1;
+
+  // The distance (in t, where from + t * dir) to cross one cell,
+  // and to reach the first cell boundary on each axis.
+  float inf = numeric_limits<float>::infinity();
+  float tDeltaX = (dir.x != 0) ? _cellSize / std::abs(dir.x) : inf;
+  float tDeltaY = (dir.y != 0) ? _cellSize / std::abs(dir.y) : inf;
+  float tMaxX = (dir.x != 0) ? ((x + (stepX > 0)) * _cellSize - from.x) / dir.x : inf;
+  float tMaxY = (dir.y != 0) ? ((y + (stepY > 0)) * _cellSize - from.y) / dir.y : inf;
+
+  // The start and end cells are skipped: a character's body may share
+  // its cell with the wall it leans against (see the header).
+  while (true) {
+    if (tMaxX < tMaxY) {
+      tMaxX += tDeltaX;
+      x += stepX;
+    } else {
+      tMaxY += tDeltaY;
+      y += stepY;
+    }
+    if (x == endX && y == endY) {
+      return true;
+    }
+    if (tMaxX > 1 + tDeltaX && tMaxY > 1 + tDeltaY) {
+      return true; // overshot due to floating point errors
+    }
+    if (test(x, y, Layer::SOLID)) {
+      return false;
+    }
+  }
+}
+
+bool OccupancyGrid::hasGroundAhead(const b2Vec2& feetPos, bool isFacingRight, float maxDrop) const {
+  int x = getCellCoord(feetPos.x + ((isFacingRight) ? _cellSize : -_cellSize));
+  int top = getCellCoord(feetPos.y + _cellSize); // slopes going up count as ground too
+  int bottom = getCellCoord(feetPos.y - maxDrop);
+
+  for (int y = top; y >= bottom; y--) {
+    if (test(x, y, Layer::SOLID) || test(x, y, Layer::PLATFORM)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool OccupancyGrid::hasCeiling(const b2Vec2& headPos, float clearance) const {
+  int x = getCellCoord(headPos.x);
+  int bottom = getCellCoord(headPos.y);
+  int top = getCellCoord(headPos.y + clearance);
+
+  for (int y = bottom; y <= top; y++) {
+    if (test(x, y, Layer::SOLID)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+void OccupancyGrid::rasterizePolylines(TMXTiledMap* tmxTiledMap, const string& layerName) {
+  for (auto& lineObj : tmxTiledMap->getObjectGroup(layerName)->getObjects()) {
+    vector<b2Vec2> vertices = GameMap::getPolylineVertices(lineObj.asValueMap());
+    for (size_t i = 1; i < vertices.size(); i++) {
+      rasterizeSegment(1 / kPpm * vertices[i - 1], 1 / kPpm * vertices[i], Layer::SOLID);
+    }
+  }
+}
+
+void OccupancyGrid::rasterizePlatforms(TMXTiledMap* tmxTiledMap, const string& layerName) {
+  for (auto& rectObj : tmxTiledMap->getObjectGroup(layerName)->getObjects()) {
+    auto& valMap = rectObj.asValueMap();
+    float x = valMap["x"].asFloat() / kPpm;
+    float y = valMap["y"].asFloat() / kPpm;
+    float w = valMap["width"].asFloat() / kPpm;
+    float h = valMap["height"].asFloat() / kPpm;
+    // Only the top of a platform can be stood on.
+    rasterizeSegment({x, y + h}, {x + w, y + h}, Layer::PLATFORM);
+  }
+}
+
+void OccupancyGrid::rasterizeSegment(const b2Vec2& p1, const b2Vec2& p2, OccupancyGrid::Layer layer) {
+  // Sample every half cell so that no cell along the segment is skipped.
+  // Surfaces go into the cell just below them (see the header), and
+  // _kSurfaceEpsilon keeps tile-aligned ones from flipping rows on rounding.
+  b2Vec2 d = p2 - p1;
+  int steps = std::max(1, static_cast<int>(std::ceil(d.Length() / (_cellSize / 2))));
+  for (int i = 0; i <= steps; i++) {
+    b2Vec2 p = p1 + (static_cast<float>(i) / steps) * d;
+    set(getCellCoord(p.x), getCellCoord(p.y - _kSurfaceEpsilon), layer);
+  }
+}
+
+
+bool OccupancyGrid::test(int cellX, int cellY, OccupancyGrid::Layer layer) const {
+  // Outside of the map is treated as solid, so AI never walks/sees out of it.
+  if (cellX < 0 || cellY < 0 || cellX >= _width || cellY >= _height) {
+    return layer == Layer::SOLID;
+  }
+  int idx = cellY * _width + cellX;
+  return (_bits[layer][idx / 64] >> (idx % 64)) & 1;
+}
+
+void OccupancyGrid::set(int cellX, int cellY, OccupancyGrid::Layer layer) {
+  if (cellX < 0 || cellY < 0 || cellX >= _width || cellY >= _height) {
+    return;
+  }
+  int idx = cellY * _width + cellX;
+  _bits[layer][idx / 64] |= static_cast<uint64_t>(1) << (idx % 64);
+}
+
+int OccupancyGrid::getCellCoord(float coord) const {
+  return static_cast<int>(std::floor(coord / _cellSize));
+}
+
+} // namespace vigilante
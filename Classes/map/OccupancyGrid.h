@@ -0,0 +1,68 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_OCCUPANCY_GRID_H_
+#define VIGILANTE_OCCUPANCY_GRID_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <cocos2d.h>
+#include <Box2D/Box2D.h>
+
+namespace vigilante {
+
+// OccupancyGrid is a tile-sized bitset of a GameMap's collision geometry,
+// built once at map load from the TMX Ground/Wall/Platform layers.
+//
+// It answers the spatial questions asked by the AI (line of sight,
+// is there ground ahead, is there a ceiling above) by walking a few bits
+// instead of ray casting against b2World.
+//
+// Cell convention: a Ground/Platform line at height y occupies the cell
+// just below it, floor((y - _kSurfaceEpsilon) / cellSize), so a character
+// standing on it is in a free cell. Walls occupy the cells their lines pass
+// through, which may also contain the character next to them; hence
+// hasLineOfSight() ignores the start and end cells.
+//
+// All coordinates are in box2d units (meters).
+class OccupancyGrid {
+ public:
+  OccupancyGrid();
+  virtual ~OccupancyGrid() = default;
+
+  void build(cocos2d::TMXTiledMap* tmxTiledMap);
+
+  // Platforms don't block the line of sight.
+  // Neither does anything in the cells of `from` and `to`.
+  bool hasLineOfSight(const b2Vec2& from, const b2Vec2& to) const;
+  // Is there ground/platform one cell ahead of feetPos, no more than maxDrop below it?
+  bool hasGroundAhead(const b2Vec2& feetPos, bool isFacingRight, float maxDrop) const;
+  // Is there ground/wall within `clearance` above headPos?
+  bool hasCeiling(const b2Vec2& headPos, float clearance) const;
+
+ private:
+  enum Layer {
+    SOLID, // ground and walls
+    PLATFORM,
+    LAYER_SIZE
+  };
+
+  void rasterizePolylines(cocos2d::TMXTiledMap* tmxTiledMap, const std::string& layerName);
+  void rasterizePlatforms(cocos2d::TMXTiledMap* tmxTiledMap, const std::string& layerName);
+  void rasterizeSegment(const b2Vec2& p1, const b2Vec2& p2, OccupancyGrid::Layer layer);
+
+  bool test(int cellX, int cellY, OccupancyGrid::Layer layer) const;
+  void set(int cellX, int cellY, OccupancyGrid::Layer layer);
+  int getCellCoord(float coord) const;
+
+  static const float _kSurfaceEpsilon;
+
+  float _cellSize;
+  int _width;
+  int _height;
+  std::vector<std::vector<uint64_t>> _bits; // one bitset per layer, row-major
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_OCCUPANCY_GRID_H_
@@ -0,0 +1,170 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "SpatialHash.h"
+
+#include <cmath>
+#include <limits>
+
+#include "Constants.h"
+#include "DynamicActor.h"
+#include "Interactable.h"
+#include "character/Character.h"
+#include "item/WorldItem.h"
+
+using std::vector;
+
+namespace vigilante {
+
+SpatialHash::SpatialHash(float cellSize) : _cellSize(cellSize), _cells(), _actorCells() {}
+
+
+void SpatialHash::update(DynamicActor* actor, short categoryBits) {
+  CellKey key = getCellKey(actor->getBody()->GetPosition());
+
+  auto it = _actorCells.find(actor);
+  if (it != _actorCells.end()) {
+    vector<Entry>& cell = _cells[it->second];
+    for (size_t i = 0; i < cell.size(); i++) {
+      if (cell[i].actor != actor) {
+        continue;
+      }
+      // Still in the same cell, only refresh its category bits
+      // (e.g., a character's category bits become kDestroyed when killed).
+      if (it->second == key) {
+        cell[i].categoryBits = categoryBits;
+        return;
+      }
+      cell[i] = cell.back();
+      cell.pop_back();
+      break;
+    }
+    it->second = key;
+  } else {
+    _actorCells.insert({actor, key});
+  }
+
+  _cells[key].push_back({actor, categoryBits});
+}
+
+void SpatialHash::remove(DynamicActor* actor) {
+  auto it = _actorCells.find(actor);
+  if (it == _actorCells.end()) {
+    return;
+  }
+
+  vector<Entry>& cell = _cells[it->second];
+  for (size_t i = 0; i < cell.size(); i++) {
+    if (cell[i].actor == actor) {
+      cell[i] = cell.back();
+      cell.pop_back();
+      break;
+    }
+  }
+  _actorCells.erase(it);
+}
+
+void SpatialHash::clear() {
+  _cells.clear();
+  _actorCells.clear();
+}
+
+
+vector<Character*> SpatialHash::charactersInRange(const b2Vec2& pos, float radius, short categoryBits) const {
+  b2AABB aabb;
+  aabb.lowerBound = {pos.x - radius, pos.y - radius};
+  aabb.upperBound = {pos.x + radius, pos.y + radius};
+
+  vector<Entry> entries;
+  query(aabb, categoryBits & (category_bits::kPlayer | category_bits::kEnemy | category_bits::kNpc), entries);
+
+  vector<Character*> characters;
+  for (const auto& entry : entries) {
+    if ((entry.actor->getBody()->GetPosition() - pos).LengthSquared() <= radius * radius) {
+      characters.push_back(static_cast<Character*>(entry.actor));
+    }
+  }
+  return characters;
+}
+
+Interactable* SpatialHash::nearestInteractable(const b2AABB& aabb) const {
+  b2AABB queryAABB;
+  queryAABB.lowerBound = {aabb.lowerBound.x - _cellSize, aabb.lowerBound.y - _cellSize};
+  queryAABB.upperBound = {aabb.upperBound.x + _cellSize, aabb.upperBound.y + _cellSize};
+
+  vector<Entry> entries;
+  query(queryAABB, category_bits::kInteractableObject | category_bits::kNpc, entries);
+
+  b2Vec2 center = aabb.GetCenter();
+  Interactable* nearest = nullptr;
+  float minDistanceSquared = std::numeric_limits<float>::max();
+  for (const auto& entry : entries) {
+    Interactable* interactable = dynamic_cast<Interactable*>(entry.actor);
+    if (!interactable) {
+      continue;
+    }
+
+    const b2Vec2& pos = entry.actor->getBody()->GetPosition();
+    float range = interactable->getInteractionRange();
+    if (pos.x + range < aabb.lowerBound.x || pos.x - range > aabb.upperBound.x
+        || pos.y + range < aabb.lowerBound.y || pos.y - range > aabb.upperBound.y) {
+      continue;
+    }
+
+    float distanceSquared = (pos - center).LengthSquared();
+    if (distanceSquared < minDistanceSquared) {
+      minDistanceSquared = distanceSquared;
+      nearest = interactable;
+    }
+  }
+  return nearest;
+}
+
+vector<WorldItem*> SpatialHash::itemsUnder(const b2AABB& aabb) const {
+  vector<Entry> entries;
+  query(aabb, category_bits::kItem, entries);
+
+  vector<WorldItem*> items;
+  for (const auto& entry : entries) {
+    const b2Vec2& itemPos = entry.actor->getBody()->GetPosition();
+    if (itemPos.x >= aabb.lowerBound.x && itemPos.x <= aabb.upperBound.x
+        && itemPos.y >= aabb.lowerBound.y && itemPos.y <= aabb.upperBound.y) {
+      items.push_back(static_cast<WorldItem*>(entry.actor));
+    }
+  }
+  return items;
+}
+
+
+SpatialHash::CellKey SpatialHash::getCellKey(const b2Vec2& pos) const {
+  return getCellKey(getCellCoord(pos.x), getCellCoord(pos.y));
+}
+
+SpatialHash::CellKey SpatialHash::getCellKey(int cellX, int cellY) const {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+int SpatialHash::getCellCoord(float coord) const {
+  return static_cast<int>(std::floor(coord / _cellSize));
+}
+
+void SpatialHash::query(const b2AABB& aabb, short categoryBits, vector<Entry>& entries) const {
+  int minX = getCellCoord(aabb.lowerBound.x);
+  int minY = getCellCoord(aabb.lowerBound.y);
+  int maxX = getCellCoord(aabb.upperBound.x);
+  int maxY = getCellCoord(aabb.upperBound.y);
+
+  for (int x = minX; x <= maxX; x++) {
+    for (int y = minY; y <= maxY; y++) {
+      auto it = _cells.find(getCellKey(x, y));
+      if (it == _cells.end()) {
+        continue;
+      }
+      for (const auto& entry : it->second) {
+        if (entry.categoryBits & categoryBits) {
+          entries.push_back(entry);
+        }
+      }
+    }
+  }
+}
+
+} // namespace vigilante
@@ -0,0 +1,66 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_SPATIAL_HASH_H_
+#define VIGILANTE_SPATIAL_HASH_H_
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+#include <Box2D/Box2D.h>
+
+namespace vigilante {
+
+class DynamicActor;
+class Character;
+class Interactable;
+class WorldItem;
+
+// SpatialHash is a uniform grid of the dynamic actors (characters, items
+// and interactable objects) on a GameMap, which answers proximity queries
+// by visiting only the cells around the query position.
+//
+// Each actor updates its own entry when it syncs with its b2body (see
+// Character::update(), WorldItem::update() and Chest::update()), together with
+// its category bits (see Constants.h), and removes it in removeFromMap().
+//
+// All coordinates are in box2d units (meters).
+class SpatialHash {
+ public:
+  explicit SpatialHash(float cellSize=1.0f);
+  virtual ~SpatialHash() = default;
+
+  void update(DynamicActor* actor, short categoryBits);
+  void remove(DynamicActor* actor);
+  void clear();
+
+  // Characters whose category bits match `categoryBits` within `radius` of `pos`.
+  std::vector<Character*> charactersInRange(const b2Vec2& pos, float radius, short categoryBits) const;
+  // The closest interactable object or NPC whose interaction range
+  // (see Interactable::getInteractionRange()) overlaps `aabb`, or nullptr if none.
+  // Interaction ranges are assumed to be no larger than a cell.
+  Interactable* nearestInteractable(const b2AABB& aabb) const;
+  // Items whose position lies within `aabb` (e.g., a character's feet).
+  std::vector<WorldItem*> itemsUnder(const b2AABB& aabb) const;
+
+ private:
+  struct Entry {
+    DynamicActor* actor;
+    short categoryBits;
+  };
+
+  using CellKey = uint64_t;
+  SpatialHash::CellKey getCellKey(const b2Vec2& pos) const;
+  SpatialHash::CellKey getCellKey(int cellX, int cellY) const;
+  int getCellCoord(float coord) const;
+
+  // Collect the entries (matching categoryBits) in the cells overlapping `aabb`.
+  void query(const b2AABB& aabb, short categoryBits, std::vector<SpatialHash::Entry>& entries) const;
+
+  float _cellSize;
+  std::unordered_map<SpatialHash::CellKey, std::vector<SpatialHash::Entry>> _cells;
+  std::unordered_map<DynamicActor*, SpatialHash::CellKey> _actorCells;
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_SPATIAL_HASH_H_
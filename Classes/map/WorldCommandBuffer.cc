@@ -0,0 +1,64 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "WorldCommandBuffer.h"
+
+#include "Interactable.h"
+#include "character/Character.h"
+#include "map/GameMapManager.h"
+
+using std::string;
+using std::vector;
+
+namespace vigilante {
+
+WorldCommandBuffer::WorldCommandBuffer() : _commands() {}
+
+
+void WorldCommandBuffer::flush() {
+  // A command may record more commands while it is being applied
+  // (e.g., interacting with a chest spawns items), so keep swapping
+  // the buffer out until it has been drained completely.
+  while (!_commands.empty()) {
+    vector<Command> commands;
+    commands.swap(_commands);
+
+    for (const auto& cmd : commands) {
+      cmd();
+    }
+  }
+}
+
+
+void WorldCommandBuffer::push(const Command& cmd) {
+  _commands.push_back(cmd);
+}
+
+void WorldCommandBuffer::spawnItem(const string& itemJson, float x, float y, int amount) {
+  _commands.push_back([=]() {
+    GameMapManager::getInstance()->getGameMap()->spawnItem(itemJson, x, y, amount);
+  });
+}
+
+void WorldCommandBuffer::destroyBody(b2Body* body) {
+  _commands.push_back([=]() {
+    body->GetWorld()->DestroyBody(body);
+  });
+}
+
+void WorldCommandBuffer::setCategoryBits(b2Fixture* fixture, short bits) {
+  _commands.push_back([=]() {
+    Character::setCategoryBits(fixture, bits);
+  });
+}
+
+void WorldCommandBuffer::interact(Character* user, Interactable* target) {
+  _commands.push_back([=]() {
+    user->interact(target);
+  });
+}
+
+
+bool WorldCommandBuffer::empty() const {
+  return _commands.empty();
+}
+
+} // namespace vigilante
@@ -0,0 +1,47 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_WORLD_COMMAND_BUFFER_H_
+#define VIGILANTE_WORLD_COMMAND_BUFFER_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <Box2D/Box2D.h>
+
+namespace vigilante {
+
+class Character;
+class Interactable;
+
+// b2World is locked while it is being stepped, so creating/destroying
+// bodies or fixtures from within a b2ContactListener callback will crash.
+// See: https://github.com/libgdx/libgdx/issues/2730
+//
+// Instead, record these world mutations here during the callbacks,
+// and they'll be applied in order by flush() right after b2World::Step().
+class WorldCommandBuffer {
+ public:
+  using Command = std::function<void ()>;
+
+  WorldCommandBuffer();
+  virtual ~WorldCommandBuffer() = default;
+
+  // Applies all recorded commands in the order they were recorded.
+  // Commands recorded by a command during flush() are applied in the same flush.
+  void flush();
+
+  void push(const Command& cmd);
+  void spawnItem(const std::string& itemJson, float x, float y, int amount=1);
+  void destroyBody(b2Body* body);
+  void setCategoryBits(b2Fixture* fixture, short bits);
+  void interact(Character* user, Interactable* target);
+
+  bool empty() const;
+
+ private:
+  std::vector<WorldCommandBuffer::Command> _commands;
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_WORLD_COMMAND_BUFFER_H_
@@ -13,7 +13,6 @@
 #include "skill/Skill.h"
 #include "skill/MagicalMissile.h"
 #include "skill/ForwardSlash.h"
-#include "util/CallbackUtil.h"
 
 using std::unique_ptr;
 
@@ -69,13 +68,6 @@ void WorldContactListener::BeginContact(b2Contact* contact) {
       }
       break;
     }
-    case category_bits::kEnemy | category_bits::kCliffMarker: {
-      b2Fixture* enemyFixture = GetTargetFixture(category_bits::kEnemy, fixtureA, fixtureB);
-      if (enemyFixture) {
-        static_cast<Enemy*>(enemyFixture->GetUserData())->reverseDirection();
-      }
-      break;
-    }
     // Set enemy as player's current target (so player can inflict damage to enemy).
     case category_bits::kMeleeWeapon | category_bits::kEnemy: {
       b2Fixture* weaponFixture = GetTargetFixture(category_bits::kMeleeWeapon, fixtureA, fixtureB);
@@ -107,18 +99,6 @@ void WorldContactListener::BeginContact(b2Contact* contact) {
       }
       break;
     }
-    // Add the item to character's _inRangeItems set (so they can pick them up).
-    case category_bits::kFeet | category_bits::kItem: {
-      b2Fixture* feetFixture = GetTargetFixture(category_bits::kFeet, fixtureA, fixtureB);
-      b2Fixture* itemFixture = GetTargetFixture(category_bits::kItem, fixtureA, fixtureB);
-
-      if (feetFixture && itemFixture) {
-        Character* c = static_cast<Character*>(feetFixture->GetUserData());
-        Item* i = static_cast<Item*>(itemFixture->GetUserData());
-        c->getInRangeItems().insert(i);
-      }
-      break;
-    }
     // When a character gets close to a portal, register it to the character.
     case category_bits::kFeet | category_bits::kPortal: {
       b2Fixture* feetFixture = GetTargetFixture(category_bits::kFeet, fixtureA, fixtureB);
@@ -130,45 +110,7 @@ void WorldContactListener::BeginContact(b2Contact* contact) {
         c->setPortal(p);
 
         if (p->willInteractOnContact()) {
-          callback_util::runAfter([=]() {
-            c->interact(p);
-          }, .1f);
-        }
-      }
-      break;
-    }
-    // When a character gets close to an interactable object or NPC, register it to the character.
-    case category_bits::kFeet | category_bits::kInteractableObject: {
-      b2Fixture* feetFixture = GetTargetFixture(category_bits::kFeet, fixtureA, fixtureB);
-      b2Fixture* objFixture = GetTargetFixture(category_bits::kInteractableObject, fixtureA, fixtureB);
-      
-      if (feetFixture && objFixture) {
-        Character* c = static_cast<Character*>(feetFixture->GetUserData());
-        Interactable* obj = static_cast<Interactable*>(objFixture->GetUserData());
-        c->setInteractableObject(obj);
-
-        if (obj->willInteractOnContact()) {
-          callback_util::runAfter([=]() {
-            c->interact(obj);
-          }, .1f);
-        }
-      }
-      break;
-    }
-    // When a character gets close to an NPC, register it to the character.
-    case category_bits::kFeet | category_bits::kNpc: {
-      b2Fixture* feetFixture = GetTargetFixture(category_bits::kFeet, fixtureA, fixtureB);
-      b2Fixture* npcFixture = GetTargetFixture(category_bits::kNpc, fixtureA, fixtureB);
-      
-      if (feetFixture && npcFixture) {
-        Character* c = static_cast<Character*>(feetFixture->GetUserData());
-        Npc* npc = static_cast<Npc*>(npcFixture->GetUserData());
-        c->setInteractableObject(npc);
-
-        if (npc->willInteractOnContact()) {
-          callback_util::runAfter([=]() {
-            c->interact(npc);
-          }, .1f);
+          GameMapManager::getInstance()->getWorldCommandBuffer()->interact(c, p);
         }
       }
       break;
@@ -245,18 +187,6 @@ void WorldContactListener::EndContact(b2Contact* contact) {
       }
       break;
     }
-    // Remove the item from character's _inRangeItems set.
-    case category_bits::kFeet | category_bits::kItem: {
-      b2Fixture* feetFixture = GetTargetFixture(category_bits::kFeet, fixtureA, fixtureB);
-      b2Fixture* itemFixture = GetTargetFixture(category_bits::kItem, fixtureA, fixtureB);
-
-      if (feetFixture && itemFixture) {
-        Character* c = static_cast<Character*>(feetFixture->GetUserData());
-        Item* i = static_cast<Item*>(itemFixture->GetUserData());
-        c->getInRangeItems().erase(i);
-      }
-      break;
-    }
     // When a character leaves an interactable object, clear it from the character.
     case category_bits::kFeet | category_bits::kPortal: {
       b2Fixture* feetFixture = GetTargetFixture(category_bits::kFeet, fixtureA, fixtureB);
@@ -268,28 +198,6 @@ void WorldContactListener::EndContact(b2Contact* contact) {
       }
       break;
     }
-    // When a character leaves an interactable object, clear it from the character.
-    case category_bits::kFeet | category_bits::kInteractableObject: {
-      b2Fixture* feetFixture = GetTargetFixture(category_bits::kFeet, fixtureA, fixtureB);
-      b2Fixture* objFixture = GetTargetFixture(category_bits::kInteractableObject, fixtureA, fixtureB);
-      
-      if (feetFixture && objFixture) {
-        Character* c = static_cast<Character*>(feetFixture->GetUserData());
-        c->setInteractableObject(nullptr);
-      }
-      break;
-    }
-    // When a character leaves an NPC, clear it from the character.
-    case category_bits::kFeet | category_bits::kNpc: {
-      b2Fixture* feetFixture = GetTargetFixture(category_bits::kFeet, fixtureA, fixtureB);
-      b2Fixture* npcFixture = GetTargetFixture(category_bits::kNpc, fixtureA, fixtureB);
-      
-      if (feetFixture && npcFixture) {
-        Character* c = static_cast<Character*>(feetFixture->GetUserData());
-        c->setInteractableObject(nullptr);
-      }
-      break;
-    }
     default:
       break;
   }
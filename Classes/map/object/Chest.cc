@@ -14,12 +14,11 @@ using vigilante::category_bits::kInteractableObject;
 using vigilante::category_bits::kGround;
 using vigilante::category_bits::kPlatform;
 using vigilante::category_bits::kWall;
-using vigilante::category_bits::kFeet;
 
 namespace vigilante {
 
 const int Chest::_kNumAnimations = 0;
-const int Chest::_kNumFixtures = 2;
+const int Chest::_kNumFixtures = 1;
 
 Chest::Chest() : DynamicActor(_kNumAnimations, _kNumFixtures), _isOpened() {}
 
@@ -41,6 +40,11 @@ void Chest::showOnMap(float x, float y) {
   GameMapManager::getInstance()->getLayer()->addChild(_bodySprite, graphical_layers::kChest);
 }
 
+void Chest::update(float delta) {
+  DynamicActor::update(delta);
+  GameMapManager::getInstance()->getGameMap()->getSpatialHash().update(this, kInteractableObject);
+}
+
 void Chest::defineBody(b2BodyType bodyType, short categoryBits, short maskBits, float x, float y) {
   b2BodyBuilder bodyBuilder(GameMapManager::getInstance()->getWorld());
 
@@ -48,13 +52,6 @@ void Chest::defineBody(b2BodyType bodyType, short categoryBits, short maskBits,
     .position(x, y, kPpm)
     .buildBody();
 
-  bodyBuilder.newRectangleFixture(16 / 2, 16 / 2, kPpm)
-    .categoryBits(categoryBits)
-    .maskBits(maskBits | kFeet)
-    .setSensor(true)
-    .setUserData(this)
-    .buildFixture();
-
   bodyBuilder.newRectangleFixture(16 / 2, 16 / 2, kPpm)
     .categoryBits(categoryBits)
     .maskBits(maskBits)
@@ -87,4 +84,9 @@ bool Chest::willInteractOnContact() const {
   return false;
 }
 
+float Chest::getInteractionRange() const {
+  // The size of its body.
+  return 16 / 2 / kPpm;
+}
+
 } // namespace 
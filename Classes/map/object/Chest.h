@@ -16,9 +16,11 @@ class Chest : public Interactable, public DynamicActor {
   Chest();
   virtual ~Chest() = default;
   virtual void showOnMap(float x, float y) override; // DynamicActor
+  virtual void update(float delta) override; // DynamicActor
 
   virtual void onInteract(Character* user) override; // Interactable
   virtual bool willInteractOnContact() const override; // Interactable
+  virtual float getInteractionRange() const override; // Interactable
 
   std::vector<std::string>& getItemJsons();
 
@@ -2,7 +2,6 @@
 #include "CollectItemObjective.h"
 
 #include "character/Player.h"
-#include "item/Item.h"
 #include "map/GameMapManager.h"
 
 using std::string;
@@ -12,13 +11,23 @@ namespace vigilante {
 CollectItemObjective::CollectItemObjective(const string& desc,
                                            const string& itemName,
                                            int amount)
-    : Quest::Objective(Quest::Objective::Type::COLLECT, desc),
+    : Quest::Objective(Quest::Objective::Type::COLLECT, itemName, desc),
       _itemName(itemName),
-      _amount(amount) {}
+      _amount(amount),
+      _currentAmount() {}
 
 
 bool CollectItemObjective::isCompleted() const {
-  return GameMapManager::getInstance()->getPlayer()->getItemAmount(_itemName) >= _amount;
+  return _currentAmount >= _amount;
+}
+
+void CollectItemObjective::onTargetUpdated(int value) {
+  _currentAmount = value;
+}
+
+void CollectItemObjective::onActivated() {
+  // The player may already have some of them.
+  _currentAmount = GameMapManager::getInstance()->getPlayer()->getItemAmount(_target);
 }
 
 const string& CollectItemObjective::getItemName() const {
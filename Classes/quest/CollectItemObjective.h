@@ -16,6 +16,8 @@ class CollectItemObjective : public Quest::Objective {
   virtual ~CollectItemObjective() = default;
 
   virtual bool isCompleted() const override;
+  virtual void onTargetUpdated(int value) override;
+  virtual void onActivated() override;
 
   const std::string& getItemName() const;
   int getAmount() const;
@@ -23,6 +25,7 @@ class CollectItemObjective : public Quest::Objective {
  private:
   std::string _itemName;
   int _amount;
+  int _currentAmount; // the number of this item in the player's inventory
 };
 
 } // namespace vigilante
@@ -8,7 +8,7 @@ namespace vigilante {
 KillTargetObjective::KillTargetObjective(const string& desc,
                                          const string& characterName,
                                          int targetAmount)
-    : Quest::Objective(Quest::Objective::Type::KILL, desc),
+    : Quest::Objective(Quest::Objective::Type::KILL, characterName, desc),
       _characterName(characterName),
       _targetAmount(targetAmount),
       _currentAmount() {}
@@ -18,6 +18,10 @@ bool KillTargetObjective::isCompleted() const {
   return _currentAmount >= _targetAmount;
 }
 
+void KillTargetObjective::onTargetUpdated(int value) {
+  _currentAmount += value;
+}
+
 
 const string& KillTargetObjective::getCharacterName() const {
   return _characterName;
@@ -31,8 +35,8 @@ int KillTargetObjective::getCurrentAmount() const {
   return _currentAmount;
 }
 
-void KillTargetObjective::incrementCurrentAmount() {
-  _currentAmount++;
+void KillTargetObjective::setCurrentAmount(int currentAmount) {
+  _currentAmount = currentAmount;
 }
 
 } // namespace vigilante
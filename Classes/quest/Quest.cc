@@ -1,16 +1,14 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "Quest.h"
 
-#include <algorithm>
-
 #include <json/document.h>
 #include "quest/CollectItemObjective.h"
 #include "quest/KillTargetObjective.h"
+#include "quest/TalkToTargetObjective.h"
 #include "util/JsonUtil.h"
 
 using std::string;
 using std::vector;
-using std::unordered_map;
 using rapidjson::Document;
 
 namespace vigilante {
@@ -39,34 +37,22 @@ void Quest::advanceStage() {
   if (isCompleted()) {
     return;
   }
- 
-  if (_currentStageIdx >= 0) {
-    switch (getCurrentStage().objective->getObjectiveType()) {
-      case Quest::Objective::Type::KILL: {
-        KillTargetObjective* objective = dynamic_cast<KillTargetObjective*>(getCurrentStage().objective);
-        KillTargetObjective::removeRelatedObjective(objective->getCharacterName(), objective);
-        break;
-      }
-      default: {
-        break;
-      }
-    }
-  }
+  setCurrentStageIdx(_currentStageIdx + 1);
+}
 
-  _currentStageIdx++;
+void Quest::setCurrentStageIdx(int stageIdx) {
+  _currentStageIdx = stageIdx;
+}
 
+void Quest::compact() {
   if (!isCompleted()) {
-    switch (getCurrentStage().objective->getObjectiveType()) {
-      case Quest::Objective::Type::KILL: {
-        KillTargetObjective* objective = dynamic_cast<KillTargetObjective*>(getCurrentStage().objective);
-        KillTargetObjective::addRelatedObjective(objective->getCharacterName(), objective);
-        break;
-      }
-      default: {
-        break;
-      }
-    }
+    return;
+  }
+  for (const auto& stage : _questProfile.stages) {
+    delete stage.objective;
   }
+  // _currentStageIdx is left as is, so the quest stays completed.
+  vector<Quest::Stage>().swap(_questProfile.stages);
 }
 
 bool Quest::isUnlocked() const {
@@ -74,7 +60,7 @@ bool Quest::isUnlocked() const {
 }
 
 bool Quest::isCompleted() const {
-  return _currentStageIdx == (int) _questProfile.stages.size();
+  return _currentStageIdx >= (int) _questProfile.stages.size();
 }
 
 const Quest::Profile& Quest::getQuestProfile() const {
@@ -85,37 +71,26 @@ const Quest::Stage& Quest::getCurrentStage() const {
   return _questProfile.stages.at(_currentStageIdx);
 }
 
+int Quest::getCurrentStageIdx() const {
+  return _currentStageIdx;
+}
 
 
 
-unordered_map<string, vector<Quest::Objective*>> Quest::Objective::_relatedObjectives;
-const vector<Quest::Objective*> Quest::Objective::_kEmptyVector(0);
 
-Quest::Objective::Objective(Objective::Type objectiveType, const string& desc)
-    : _objectiveType(objectiveType), _desc(desc) {}
+Quest::Objective::Objective(Objective::Type objectiveType, const string& targetName, const string& desc)
+    : _objectiveType(objectiveType), _target(targetName), _desc(desc) {}
 
 Quest::Objective::Type Quest::Objective::getObjectiveType() const {
   return _objectiveType;
 }
 
-const string& Quest::Objective::getDesc() const {
-  return _desc;
-}
-
-void Quest::Objective::addRelatedObjective(const string& key, Quest::Objective* objective) {
-  _relatedObjectives[key].push_back(objective);
-}
-
-void Quest::Objective::removeRelatedObjective(const string& key, Quest::Objective* objective) {
-  auto& objs = _relatedObjectives[key];
-  objs.erase(std::remove(objs.begin(), objs.end(), objective), objs.end());
+Atom Quest::Objective::getTarget() const {
+  return _target;
 }
 
-const vector<Quest::Objective*>& Quest::Objective::getRelatedObjectives(const string& key) {
-  if (_relatedObjectives.find(key) == _relatedObjectives.end()) {
-    return _kEmptyVector;
-  }
-  return _relatedObjectives.at(key);
+const string& Quest::Objective::getDesc() const {
+  return _desc;
 }
 
 
@@ -156,6 +131,9 @@ Quest::Profile::Profile(const string& jsonFileName) : jsonFileName(jsonFileName)
         break;
       }
       case Quest::Objective::Type::TALK_TO: {
+        string targetName = stageJson["objective"]["targetName"].GetString();
+        Objective* objective = new TalkToTargetObjective(objectiveDesc, targetName);
+        stages.push_back(Stage(objective));
         break;
       }
       default: {
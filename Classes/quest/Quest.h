@@ -4,9 +4,9 @@
 
 #include <string>
 #include <vector>
-#include <unordered_map>
 
 #include "Importable.h"
+#include "util/Atom.h"
 
 namespace vigilante {
 
@@ -26,26 +26,27 @@ class Quest : public Importable {
       ESCORT,
       DELIVERY,
       TALK_TO,
-      AD_HOC
+      AD_HOC,
+      SIZE
     };
 
     virtual bool isCompleted() const = 0;
+    // Updates the progress in place when something happens to the target
+    // (see QuestBook::update()), e.g., the number of kills or items.
+    virtual void onTargetUpdated(int value) = 0;
+    // Called when the stage of this objective is reached.
+    virtual void onActivated() {}
 
     Objective::Type getObjectiveType() const;
+    // The name of the target (a character, an item, ...).
+    Atom getTarget() const;
     const std::string& getDesc() const;
 
-    // Provide a key and get all objectives related to this key.
-    static void addRelatedObjective(const std::string& key, Quest::Objective* objective);
-    static void removeRelatedObjective(const std::string& key, Quest::Objective* objective);
-    static const std::vector<Quest::Objective*>& getRelatedObjectives(const std::string& key);
-
    protected:
-    Objective(Objective::Type objectiveType, const std::string& desc);
-
-    static std::unordered_map<std::string, std::vector<Quest::Objective*>> _relatedObjectives;
-    static const std::vector<Quest::Objective*> _kEmptyVector;
+    Objective(Objective::Type objectiveType, const std::string& targetName, const std::string& desc);
 
     Objective::Type _objectiveType;
+    Atom _target;
     std::string _desc;
   };
 
@@ -75,12 +76,19 @@ class Quest : public Importable {
   
   void unlock();
   void advanceStage();
+  // Jumps to a stage directly. -1 means not started,
+  // and stages.size() means completed.
+  void setCurrentStageIdx(int stageIdx);
+  // Releases the stages (and their objectives) of a completed quest,
+  // keeping only its title and desc.
+  void compact();
 
   bool isUnlocked() const;
   bool isCompleted() const;
 
   const Quest::Profile& getQuestProfile() const;
   const Quest::Stage& getCurrentStage() const;
+  int getCurrentStageIdx() const;
 
  private:
   Quest::Profile _questProfile;
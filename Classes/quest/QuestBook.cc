@@ -5,7 +5,6 @@
 #include <algorithm>
 #include <stdexcept>
 
-#include "quest/KillTargetObjective.h"
 #include "ui/quest_hints/QuestHints.h"
 #include "util/StringUtil.h"
 #include "util/Logger.h"
@@ -14,12 +13,12 @@ using std::string;
 using std::vector;
 using std::ifstream;
 using std::unique_ptr;
-using std::unordered_map;
 using std::runtime_error;
 
 namespace vigilante {
 
-QuestBook::QuestBook(const string& questsListFileName) {
+QuestBook::QuestBook(const string& questsListFileName)
+    : _questMapper(), _objectiveIndex(), _inProgressQuests(), _completedQuests(), _version(1) {
   ifstream fin(questsListFileName);
   if (!fin.is_open()) {
     throw runtime_error("Failed to open quest list: " + questsListFileName);
@@ -27,27 +26,22 @@ QuestBook::QuestBook(const string& questsListFileName) {
 
   string line;
   while (std::getline(fin, line)) {
-    _questMapper[line] = unique_ptr<Quest>(new Quest(line));
+    _questMapper[Atom(line)] = nullptr;
   }
 }
 
 
-void QuestBook::update(Quest::Objective::Type objectiveType) {
-  VGLOG(LOG_INFO, "Updating quests");
-  for (const auto quest : _inProgressQuests) {
-    if (quest->getCurrentStage().objective->getObjectiveType() != objectiveType) {
-      continue;
-    }
-
-    while (!quest->isCompleted() && quest->getCurrentStage().objective->isCompleted()) {
-      quest->advanceStage();
+void QuestBook::update(Quest::Objective::Type objectiveType, Atom target, int value) {
+  const vector<Quest*>* affectedQuests = _objectiveIndex[objectiveType].find(target);
+  if (!affectedQuests || affectedQuests->empty()) {
+    return;
+  }
 
-      if (quest->isCompleted()) {
-        markCompleted(quest);
-      } else {
-        QuestHints::getInstance()->show(quest->getCurrentStage().objective->getDesc());
-      }
-    }
+  // Copy the affected quests, since advancing their stages modifies the index.
+  vector<Quest*> quests = *affectedQuests;
+  for (auto quest : quests) {
+    quest->getCurrentStage().objective->onTargetUpdated(value);
+    evaluate(quest);
   }
 }
 
@@ -65,7 +59,7 @@ void QuestBook::startQuest(Quest* quest) {
   // Add this quest to _inProgressQuests.
   qs.push_back(quest);
 
-  quest->advanceStage();
+  setQuestStage(quest, quest->getCurrentStageIdx() + 1);
   QuestHints::getInstance()->show("Started: " + quest->getQuestProfile().title);
   QuestHints::getInstance()->show(quest->getCurrentStage().objective->getDesc());
 }
@@ -76,34 +70,60 @@ void QuestBook::markCompleted(Quest* quest) {
     return;
   }
 
+  // Skip the remaining stages (if any), so its objective is unindexed.
+  setQuestStage(quest, quest->getQuestProfile().stages.size());
+
   // Erase this quest from _inProgressQuests,
   // and add it to _completedQuests.
   qs.erase(std::remove(qs.begin(), qs.end(), quest), qs.end());
   _completedQuests.push_back(quest);
+  quest->compact();
 
   QuestHints::getInstance()->show("Completed: " + quest->getQuestProfile().title);
 }
 
 
 void QuestBook::unlockQuest(const string& questJsonFileName) {
-  if (_questMapper.find(questJsonFileName) == _questMapper.end()) {
+  Quest* quest = getQuest(questJsonFileName);
+  if (!quest) {
     return;
   }
-  unlockQuest(_questMapper[questJsonFileName].get());
+  unlockQuest(quest);
 }
 
 void QuestBook::startQuest(const string& questJsonFileName) {
-  if (_questMapper.find(questJsonFileName) == _questMapper.end()) {
+  Quest* quest = getQuest(questJsonFileName);
+  if (!quest) {
     return;
   }
-  startQuest(_questMapper[questJsonFileName].get());
+  startQuest(quest);
 }
 
 void QuestBook::markCompleted(const string& questJsonFileName) {
-  if (_questMapper.find(questJsonFileName) == _questMapper.end()) {
+  Quest* quest = getQuest(questJsonFileName);
+  if (!quest) {
     return;
   }
-  markCompleted(_questMapper[questJsonFileName].get());
+  markCompleted(quest);
+}
+
+
+Quest* QuestBook::restoreQuest(const string& questJsonFileName, int stageIdx) {
+  Quest* quest = getQuest(questJsonFileName);
+  if (!quest) {
+    return nullptr;
+  }
+
+  int numStages = quest->getQuestProfile().stages.size();
+  setQuestStage(quest, std::max(-1, std::min(stageIdx, numStages)));
+
+  if (quest->isCompleted()) {
+    _completedQuests.push_back(quest);
+    quest->compact();
+  } else if (quest->getCurrentStageIdx() >= 0) {
+    _inProgressQuests.push_back(quest);
+  }
+  return quest;
 }
 
 
@@ -113,6 +133,16 @@ vector<Quest*> QuestBook::getAllQuests() const {
   return allQuests;
 }
 
+vector<Quest*> QuestBook::getLoadedQuests() const {
+  vector<Quest*> loadedQuests;
+  for (const auto& entry : _questMapper) {
+    if (entry.second) {
+      loadedQuests.push_back(entry.second.get());
+    }
+  }
+  return loadedQuests;
+}
+
 const vector<Quest*>& QuestBook::getInProgressQuests() const {
   return _inProgressQuests;
 }
@@ -121,4 +151,49 @@ const vector<Quest*>& QuestBook::getCompletedQuests() const {
   return _completedQuests;
 }
 
+uint32_t QuestBook::getVersion() const {
+  return _version;
+}
+
+
+Quest* QuestBook::getQuest(const string& questJsonFileName) {
+  unique_ptr<Quest>* quest = _questMapper.find(Atom(questJsonFileName));
+  if (!quest) {
+    return nullptr;
+  }
+  if (!*quest) {
+    *quest = unique_ptr<Quest>(new Quest(questJsonFileName));
+  }
+  return quest->get();
+}
+
+void QuestBook::setQuestStage(Quest* quest, int stageIdx) {
+  if (quest->getCurrentStageIdx() >= 0 && !quest->isCompleted()) {
+    const Quest::Objective* objective = quest->getCurrentStage().objective;
+    vector<Quest*>& qs = _objectiveIndex[objective->getObjectiveType()][objective->getTarget()];
+    qs.erase(std::remove(qs.begin(), qs.end(), quest), qs.end());
+  }
+
+  quest->setCurrentStageIdx(stageIdx);
+  _version++;
+
+  if (quest->getCurrentStageIdx() >= 0 && !quest->isCompleted()) {
+    Quest::Objective* objective = quest->getCurrentStage().objective;
+    _objectiveIndex[objective->getObjectiveType()][objective->getTarget()].push_back(quest);
+    objective->onActivated();
+  }
+}
+
+void QuestBook::evaluate(Quest* quest) {
+  while (!quest->isCompleted() && quest->getCurrentStage().objective->isCompleted()) {
+    setQuestStage(quest, quest->getCurrentStageIdx() + 1);
+
+    if (quest->isCompleted()) {
+      markCompleted(quest);
+    } else {
+      QuestHints::getInstance()->show(quest->getCurrentStage().objective->getDesc());
+    }
+  }
+}
+
 } // namespace vigilante
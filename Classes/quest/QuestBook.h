@@ -2,21 +2,31 @@
 #ifndef VIGILANTE_QUEST_BOOK_H_
 #define VIGILANTE_QUEST_BOOK_H_
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
-#include <unordered_map>
 
 #include "Quest.h"
+#include "util/Atom.h"
 
 namespace vigilante {
 
+// QuestBook keeps track of the player's quests.
+//
+// Only the list of quest json files is read up front. A Quest (json, stages and
+// objectives) is loaded when it's first unlocked, started or restored, and is
+// compacted down to its title and desc once completed.
 class QuestBook {
  public:
   explicit QuestBook(const std::string& questsListFileName);
   virtual ~QuestBook() = default;
 
-  void update(const Quest::Objective::Type objectiveType);
+  // Notifies the in-progress objectives of (objectiveType, targetName), e.g.,
+  // (KILL, "Slime", 1) or (COLLECT, "Gold Coin", <amount now in the inventory>),
+  // and re-evaluates only the quests they belong to.
+  void update(Quest::Objective::Type objectiveType, Atom target, int value=1);
 
   void unlockQuest(Quest* quest);
   void startQuest(Quest* quest);
@@ -26,14 +36,34 @@ class QuestBook {
   void startQuest(const std::string& questJsonFileName);
   void markCompleted(const std::string& questJsonFileName);
 
+  // Puts a quest back to the given stage without showing any hints (see SaveGame.h).
+  // Returns nullptr if there's no such quest.
+  Quest* restoreQuest(const std::string& questJsonFileName, int stageIdx);
+
   std::vector<Quest*> getAllQuests() const;
+  // Every quest which has been loaded, including the unlocked ones which haven't been started.
+  std::vector<Quest*> getLoadedQuests() const;
   const std::vector<Quest*>& getInProgressQuests() const;
   const std::vector<Quest*>& getCompletedQuests() const;
 
+  // Bumped whenever a quest moves to another stage. Starts at 1 (see Character::getInventoryVersion()).
+  uint32_t getVersion() const;
+
  private:
-  std::unordered_map<std::string, std::unique_ptr<Quest>> _questMapper;
+  // Returns nullptr if there's no such quest.
+  Quest* getQuest(const std::string& questJsonFileName);
+  // Moves a quest to another stage, keeping _objectiveIndex in sync.
+  void setQuestStage(Quest* quest, int stageIdx);
+  // Advances a quest past all of its completed stages.
+  void evaluate(Quest* quest);
+
+  // Quests which haven't been loaded yet are mapped to nullptr.
+  AtomMap<std::unique_ptr<Quest>> _questMapper; // keyed by json file name
+  // The in-progress quests, indexed by [objectiveType][target] of their current objective.
+  std::array<AtomMap<std::vector<Quest*>>, Quest::Objective::Type::SIZE> _objectiveIndex;
   std::vector<Quest*> _inProgressQuests;
   std::vector<Quest*> _completedQuests;
+  uint32_t _version;
 };
 
 } // namespace vigilante
@@ -0,0 +1,27 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "TalkToTargetObjective.h"
+
+using std::string;
+
+namespace vigilante {
+
+TalkToTargetObjective::TalkToTargetObjective(const string& desc, const string& targetName)
+    : Quest::Objective(Quest::Objective::Type::TALK_TO, targetName, desc),
+      _targetName(targetName),
+      _hasTalkedTo() {}
+
+
+bool TalkToTargetObjective::isCompleted() const {
+  return _hasTalkedTo;
+}
+
+void TalkToTargetObjective::onTargetUpdated(int) {
+  _hasTalkedTo = true;
+}
+
+
+const string& TalkToTargetObjective::getTargetName() const {
+  return _targetName;
+}
+
+} // namespace vigilante
@@ -10,10 +10,17 @@ namespace vigilante {
 
 class TalkToTargetObjective : public Quest::Objective {
  public:
-  explicit TalkToTargetObjective(const std::string& desc);
+  TalkToTargetObjective(const std::string& desc, const std::string& targetName);
   virtual ~TalkToTargetObjective() = default;
 
   virtual bool isCompleted() const override;
+  virtual void onTargetUpdated(int value) override;
+
+  const std::string& getTargetName() const;
+
+ private:
+  std::string _targetName;
+  bool _hasTalkedTo;
 };
 
 } // namespace vigilante
@@ -8,7 +8,9 @@
 #include "Constants.h"
 #include "character/Player.h"
 #include "gameplay/ExpPointTable.h"
+#include "gameplay/SaveGame.h"
 #include "input/InputManager.h"
+#include "input/InputRecorder.h"
 #include "map/GameMap.h"
 #include "skill/Skill.h"
 #include "quest/Quest.h"
@@ -27,11 +29,27 @@ using cocos2d::Camera;
 using cocos2d::CameraFlag;
 using cocos2d::Director;
 using cocos2d::Layer;
+using cocos2d::Scheduler;
 using cocos2d::EventKeyboard;
 using cocos2d::ui::ImageView;
 
 namespace vigilante {
 
+const float MainGameScene::_kBenchmarkFrameTime = .1f;
+
+MainGameScene* MainGameScene::create(const string& saveFileName) {
+  MainGameScene* scene = new (std::nothrow) MainGameScene();
+  if (scene) {
+    scene->_saveFileName = saveFileName;
+  }
+  if (scene && scene->init()) {
+    scene->autorelease();
+    return scene;
+  }
+  delete scene;
+  return nullptr;
+}
+
 bool MainGameScene::init() {
   if (!Scene::init()) {
     return false;
@@ -100,20 +118,33 @@ bool MainGameScene::init() {
   exp_point_table::import(asset_manager::kExpPointTable);
 
   // Initialize Vigilante's utils.
+  // A replay starts with the same RNG seed and map as the recorded session.
+  InputRecorder* recorder = InputRecorder::getInstance();
   vigilante::callback_util::init(this);
   vigilante::keycode_util::init();
-  vigilante::rand_util::init();
+  if (recorder->isReplaying()) {
+    vigilante::rand_util::init(recorder->getSeed());
+  } else {
+    vigilante::rand_util::init();
+  }
+
+  // Continue from the save file (if any). Replays always start a new game.
+  SaveGame saveGame(_saveFileName);
+  bool isLoadingGame = !_saveFileName.empty() && !recorder->isReplaying() && saveGame.load();
+
+  string tmxMapFileName = "Map/prison_cell1.tmx";
+  if (recorder->isReplaying()) {
+    tmxMapFileName = recorder->getTmxMapFileName();
+  } else if (isLoadingGame) {
+    tmxMapFileName = saveGame.getTmxMapFileName();
+  }
   
   // Initialize GameMapManager.
   // b2World is created when GameMapManager's ctor is called.
   _gameMapManager = unique_ptr<GameMapManager>(GameMapManager::getInstance());
-  _gameMapManager->loadGameMap("Map/prison_cell1.tmx");
+  _gameMapManager->loadGameMap(tmxMapFileName);
   addChild(static_cast<Layer*>(_gameMapManager->getLayer()));
 
-
-  _gameMapManager->getPlayer()->addItem(Item::create("Resources/Database/item/equipment/short_sword.json"));
-  _gameMapManager->getPlayer()->addItem(Item::create("Resources/Database/item/equipment/royal_cape.json"));
-
   // Initialize InputManager.
   // InputManager keep tracks of which keys are pressed.
   InputManager::getInstance()->activate(this);
@@ -126,9 +157,15 @@ bool MainGameScene::init() {
   _hud->setPlayer(_gameMapManager->getPlayer());
 
   auto player = _gameMapManager->getPlayer();
-  player->getSkills().push_back(Skill::create("Resources/Database/skill/back_dash.json", player));
-  player->getSkills().push_back(Skill::create("Resources/Database/skill/forward_slash.json", player));
-  player->getSkills().push_back(Skill::create("Resources/Database/skill/ice_spike.json", player));
+  if (isLoadingGame) {
+    saveGame.restore(player);
+  } else {
+    player->addItem("Resources/Database/item/equipment/short_sword.json");
+    player->addItem("Resources/Database/item/equipment/royal_cape.json");
+    player->addSkill(Skill::create("Resources/Database/skill/back_dash.json", player));
+    player->addSkill(Skill::create("Resources/Database/skill/forward_slash.json", player));
+    player->addSkill(Skill::create("Resources/Database/skill/ice_spike.json", player));
+  }
 
   //player->getQuestBook().startQuest("Resources/Database/quest/main/main01.json");
   //_console->executeCmd("startquest Resources/Database/quest/main/main01.json");
@@ -140,34 +177,110 @@ bool MainGameScene::init() {
   _pauseMenu->getLayer()->setVisible(false);
   addChild(_pauseMenu->getLayer(), graphical_layers::kPauseMenu);
 
+  // Start recording (if requested via the command line).
+  // While recording or replaying, cocos2d actions (fades, delayed callbacks)
+  // are advanced by step() with the fixed delta instead of the wall time.
+  recorder->beginSession(vigilante::rand_util::getSeed(), tmxMapFileName, !isLoadingGame);
+  if (recorder->isFixedStep()) {
+    Director::getInstance()->getScheduler()->unscheduleUpdate(Director::getInstance()->getActionManager());
+  }
+  _benchmarkTime = Profiler::Clock::duration::zero();
+
   // Tick the box2d world.
   schedule(schedule_selector(MainGameScene::update));
   return true;
 }
 
 void MainGameScene::update(float delta) {
-  // REVIEW this method
-  handleInput();
+  InputRecorder* recorder = InputRecorder::getInstance();
 
-  if (_pauseMenu->getLayer()->isVisible()) {
-    return;
+  if (recorder->isBenchmarkMode()) {
+    runBenchmark();
+  } else {
+    step((recorder->isFixedStep()) ? 1 / kFps : delta);
+    if (recorder->hasFinishedReplay()) {
+      finishReplay();
+    }
+  }
+}
+
+void MainGameScene::step(float delta) {
+  InputRecorder* recorder = InputRecorder::getInstance();
+
+  if (recorder->isFixedStep()) {
+    Director::getInstance()->getActionManager()->update(delta);
+  }
+  if (recorder->isReplaying()) {
+    recorder->replayKeyEvents();
   }
 
-  // If there are no ongoing GameMap transitions, then step the box2d world.
-  if (_shade->getImageView()->getNumberOfRunningActions() == 0) {
-    getWorld()->Step(1 / kFps, kVelocityIterations, kPositionIterations);
+  {
+    Profiler::Scope scope(_profiler, "input");
+    handleInput();
   }
 
-  _gameMapManager->update(delta);
-  _floatingDamages->update(delta);
-  _notifications->update(delta);
-  _questHints->update(delta);
-  _dialogueManager->update(delta);
-  _console->update(delta);
+  if (!_pauseMenu->getLayer()->isVisible()) {
+    // If there are no ongoing GameMap transitions, then step the box2d world.
+    if (_shade->getImageView()->getNumberOfRunningActions() == 0) {
+      Profiler::Scope scope(_profiler, "physics");
+      getWorld()->Step(1 / kFps, kVelocityIterations, kPositionIterations);
+      // Apply the world mutations recorded during b2ContactListener callbacks.
+      _gameMapManager->getWorldCommandBuffer()->flush();
+    }
+
+    {
+      Profiler::Scope scope(_profiler, "gamemap");
+      _gameMapManager->update(delta);
+    }
+
+    {
+      Profiler::Scope scope(_profiler, "ui");
+      _hud->update(delta);
+      _floatingDamages->update(delta);
+      _notifications->update(delta);
+      _questHints->update(delta);
+      _dialogueManager->update(delta);
+      _console->update(delta);
+    }
+
+    {
+      Profiler::Scope scope(_profiler, "camera");
+      vigilante::camera_util::lerpToTarget(_gameCamera, _gameMapManager->getPlayer()->getBody()->GetPosition());
+      vigilante::camera_util::boundCamera(_gameCamera, _gameMapManager->getGameMap());
+      vigilante::camera_util::updateShake(_gameCamera, delta);
+    }
+  }
+
+  InputManager::getInstance()->nextTick();
+  recorder->nextTick();
+}
+
+void MainGameScene::runBenchmark() {
+  // Headless rendering isn't supported by cocos2d-x's desktop GLView, so instead
+  // render only one frame per _kBenchmarkFrameTime to keep the window responsive.
+  InputRecorder* recorder = InputRecorder::getInstance();
+  Profiler::Clock::time_point begin = Profiler::Clock::now();
+
+  while (!recorder->hasFinishedReplay()
+      && Profiler::Clock::now() - begin < std::chrono::duration<float>(_kBenchmarkFrameTime)) {
+    step(1 / kFps);
+  }
+  _benchmarkTime += Profiler::Clock::now() - begin;
+
+  if (recorder->hasFinishedReplay()) {
+    double seconds = std::chrono::duration<double>(_benchmarkTime).count();
+    VGLOG(LOG_INFO, "Benchmark: %u ticks in %.3f s (%.1f ticks/sec)",
+          recorder->getTick(), seconds, recorder->getTick() / seconds);
+    _profiler.report(recorder->getTick());
+    Director::getInstance()->end();
+  }
+}
 
-  vigilante::camera_util::lerpToTarget(_gameCamera, _gameMapManager->getPlayer()->getBody()->GetPosition());
-  vigilante::camera_util::boundCamera(_gameCamera, _gameMapManager->getGameMap());
-  vigilante::camera_util::updateShake(_gameCamera, delta);
+void MainGameScene::finishReplay() {
+  // Hand the game over to the player.
+  InputRecorder::getInstance()->stopReplay();
+  Director::getInstance()->getScheduler()->scheduleUpdate(Director::getInstance()->getActionManager(), Scheduler::PRIORITY_SYSTEM, false);
+  _notifications->show("Replay finished.");
 }
 
 void MainGameScene::handleInput() {
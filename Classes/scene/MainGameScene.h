@@ -3,6 +3,7 @@
 #define VIGILANTE_MAIN_GAME_SCENE_H_
 
 #include <memory>
+#include <string>
 
 #include <cocos2d.h>
 #include <ui/UIImageView.h>
@@ -18,12 +19,14 @@
 #include "ui/pause_menu/PauseMenu.h"
 #include "ui/quest_hints/QuestHints.h"
 #include "util/box2d/b2DebugRenderer.h"
+#include "util/Profiler.h"
 
 namespace vigilante {
 
 class MainGameScene : public cocos2d::Scene, public Controllable {
  public:
-  CREATE_FUNC(MainGameScene);
+  // Starts a new game, or continues from the save file if saveFileName isn't empty.
+  static MainGameScene* create(const std::string& saveFileName="");
   virtual ~MainGameScene() = default;
 
   virtual bool init() override; // cocos2d::Scene
@@ -33,6 +36,17 @@ class MainGameScene : public cocos2d::Scene, public Controllable {
   b2World* getWorld() const;
 
  private:
+  // Advances the game by one tick.
+  void step(float delta);
+  // Runs as many replay ticks as possible within one frame (see InputRecorder.h).
+  void runBenchmark();
+  void finishReplay();
+
+  // The wall time budget of runBenchmark() per frame.
+  static const float _kBenchmarkFrameTime;
+
+  std::string _saveFileName;
+
   cocos2d::Camera* _gameCamera;
   cocos2d::Camera* _hudCamera;
   b2DebugRenderer* _b2dr; // autorelease object
@@ -46,6 +60,9 @@ class MainGameScene : public cocos2d::Scene, public Controllable {
   std::unique_ptr<QuestHints> _questHints;
   std::unique_ptr<Notifications> _notifications;
   std::unique_ptr<GameMapManager> _gameMapManager;
+
+  Profiler _profiler;
+  Profiler::Clock::duration _benchmarkTime;
 };
 
 } // namespace vigilante
@@ -3,6 +3,8 @@
 
 #include "AssetManager.h"
 #include "MainGameScene.h"
+#include "gameplay/AutoSave.h"
+#include "gameplay/SaveGame.h"
 #include "ui/Colorscheme.h"
 
 using std::array;
@@ -76,6 +78,7 @@ bool MainMenuScene::init() {
 
 void MainMenuScene::update(float delta) {
   handleInput();
+  _inputMgr->nextTick();
 }
 
 void MainMenuScene::handleInput() {
@@ -99,8 +102,18 @@ void MainMenuScene::handleInput() {
         Director::getInstance()->pushScene(scene);
         break;
       }
-      case Option::LOAD_GAME:
+      case Option::LOAD_GAME: {
+        // The last autosave may still be on its way to the disk.
+        AutoSave::getInstance()->flush();
+        string saveFileName = SaveGame::getDefaultSaveFileName();
+        if (!SaveGame(saveFileName).exists()) {
+          break;
+        }
+        _inputMgr->deactivate();
+        Scene* scene = MainGameScene::create(saveFileName);
+        Director::getInstance()->pushScene(scene);
         break;
+      }
       case Option::OPTIONS:
         break;
       case Option::EXIT:
@@ -91,8 +91,12 @@ void MagicalMissile::onHit(Character* target) {
   _bodySprite->runAction(Sequence::createWithTwoActions(
     Animate::create(_bodyAnimations[AnimationType::ON_HIT]),
     CallFunc::create([=]() {
-      removeFromMap();
-      delete this;
+      // This CallFunc is still owned by _bodySprite's action, so the sprite
+      // must not be removed (nor this object deleted) until the action is done.
+      GameMapManager::getInstance()->getWorldCommandBuffer()->push([=]() {
+        removeFromMap();
+        delete this;
+      });
     })
   ));
 
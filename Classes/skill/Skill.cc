@@ -29,7 +29,7 @@ Skill* Skill::create(const string& jsonFileName, Character* user) {
 Skill::Profile::Profile(const string& jsonFileName) : jsonFileName(jsonFileName), hotkey() {
   Document json = json_util::parseJson(jsonFileName);
 
-  characterFramesName = json["characterFramesName"].GetString();
+  characterFramesName = Atom(json["characterFramesName"].GetString());
   framesDuration = json["framesDuration"].GetFloat();
   frameInterval = json["frameInterval"].GetFloat();
 
@@ -7,6 +7,7 @@
 #include <cocos2d.h>
 #include "Importable.h"
 #include "input/Keybindable.h"
+#include "util/Atom.h"
 
 namespace vigilante {
 
@@ -20,7 +21,7 @@ class Skill : public Importable, public Keybindable {
     virtual ~Profile() = default;
 
     std::string jsonFileName;
-    std::string characterFramesName;
+    Atom characterFramesName;
     float framesDuration;
     float frameInterval;
 
@@ -4,6 +4,7 @@
 
 #include <deque>
 #include <vector>
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <functional>
@@ -36,7 +37,9 @@ class ListView {
   virtual void scrollUp();
   virtual void scrollDown();
 
-  virtual void showFrom(int index); // show n ListViewItems starting from the specified index.
+  // Show n ListViewItems starting from the specified index.
+  // Rows which still show the same object are moved instead of being updated.
+  virtual void showFrom(int index);
   virtual void setObjects(const std::vector<T>& objects);
   virtual void setObjects(const std::deque<T>& objects);
 
@@ -56,9 +59,15 @@ class ListView {
 
     void setSelected(bool selected);
     void setVisible(bool visible);
+    bool isVisible() const;
 
     T getObject() const;
     void setObject(T object);
+    bool hasObject() const;
+    void invalidate(); // forces the next showFrom() to call setObject() on this row
+
+    // Only reloads the icon texture if `iconPath` differs from the current one.
+    void setIcon(const std::string& iconPath);
 
     cocos2d::ui::Layout* getLayout() const;
     cocos2d::ui::ImageView* getIcon() const;
@@ -70,17 +79,27 @@ class ListView {
     ListView<T>* _parent;
     TableLayout* _layout;
 
+    // Both backgrounds are loaded once, and selecting a row only toggles their visibility.
     cocos2d::ui::ImageView* _background;
+    cocos2d::ui::ImageView* _highlightedBackground;
     cocos2d::ui::ImageView* _icon;
     cocos2d::Label* _label;
+    std::string _iconPath;
     T _object;
+    bool _hasObject;
+    bool _isSelected;
   };
 
+  static const int _kListViewItemHeight;
+
+  int findRow(int begin, T object) const;
+  int findUnusedRow(int begin, int firstVisibleIndex) const;
+
   cocos2d::ui::Layout* _layout;
   cocos2d::ui::ImageView* _scrollBar;
  
   std::vector<std::unique_ptr<ListViewItem>> _listViewItems;
-  std::deque<T> _objects;
+  std::vector<T> _objects; // reused across setObjects() to avoid reallocations
   std::function<void (ListViewItem*, bool)> _setSelectedCallback; // called at the end of ListViewItem::setSelected()
   std::function<void (ListViewItem*, T)> _setObjectCallback; // called at the end of ListViewItem::setObject()
 
@@ -116,7 +135,7 @@ ListView<T>::ListView(uint8_t visibleItemCount, uint32_t width,
 
   for (int i = 0; i < visibleItemCount; i++) {
     float x = 0;
-    float y = -i * 25;
+    float y = -i * _kListViewItemHeight;
     _listViewItems.push_back(std::unique_ptr<ListViewItem>(new ListViewItem(this, x, y)));
     _listViewItems.back()->setVisible(false);
     _layout->addChild(_listViewItems[i]->getLayout());
@@ -175,15 +194,29 @@ void ListView<T>::scrollDown() {
 template <typename T>
 void ListView<T>::showFrom(int index) {
   // Show n items starting from the given index.
+  // When scrolling, most of the rows already show an object of the new window,
+  // so we only reorder those rows and update the ones which have changed.
   for (int i = 0; i < _visibleItemCount; i++) {
-    _listViewItems[i]->setSelected(false);
+    bool hasObject = index + i < (int) _objects.size();
+    int row = (hasObject) ? findRow(i, _objects[index + i]) : -1;
+    bool isReused = row != -1;
+    if (!isReused) {
+      row = findUnusedRow(i, index);
+    }
+
+    std::swap(_listViewItems[i], _listViewItems[row]);
+    ListViewItem* listViewItem = _listViewItems[i].get();
+    listViewItem->getLayout()->setPositionY(-i * _kListViewItemHeight);
+    listViewItem->setSelected(false);
 
-    if (index + i < (int) _objects.size()) {
-      _listViewItems[i]->setVisible(true);
-      T object = _objects[index + i];
-      _listViewItems[i]->setObject(object);
+    if (hasObject) {
+      listViewItem->setVisible(true);
+      if (!isReused) {
+        listViewItem->setObject(_objects[index + i]);
+      }
     } else {
-      _listViewItems[i]->setVisible(false);
+      listViewItem->setVisible(false);
+      listViewItem->invalidate();
     }
   }
 
@@ -201,8 +234,12 @@ void ListView<T>::showFrom(int index) {
 
 template <typename T>
 void ListView<T>::setObjects(const std::vector<T>& objects) {
-  // Copy all items into local deque.
-  _objects = std::deque<T>(objects.begin(), objects.end());
+  _objects.assign(objects.begin(), objects.end());
+
+  // The objects may have been modified (e.g., item amount), so refresh every row.
+  for (auto& listViewItem : _listViewItems) {
+    listViewItem->invalidate();
+  }
 
   _firstVisibleIndex = 0;
   _current = 0;
@@ -215,16 +252,7 @@ void ListView<T>::setObjects(const std::vector<T>& objects) {
 
 template <typename T>
 void ListView<T>::setObjects(const std::deque<T>& objects) {
-  // Copy all items into local deque.
-  _objects = std::deque<T>(objects);
-
-  _firstVisibleIndex = 0;
-  _current = 0;
-  showFrom(_firstVisibleIndex);
-
-  if (_objects.size() > 0) {
-    _listViewItems[0]->setSelected(true);
-  }
+  setObjects(std::vector<T>(objects.begin(), objects.end()));
 }
 
 template <typename T>
@@ -242,10 +270,10 @@ void ListView<T>::hideScrollBar() {
 
 template <typename T>
 T ListView<T>::getSelectedObject() const {
-  if (!_objects.empty() && _listViewItems[_current]) {
-    return _listViewItems[_current]->getObject();
+  if (!_objects.empty()) {
+    return _objects[_current];
   }
-  return nullptr;
+  return T();
 }
 
 template <typename T>
@@ -253,7 +281,39 @@ cocos2d::ui::Layout* ListView<T>::getLayout() const {
   return _layout;
 }
 
+template <typename T>
+int ListView<T>::findRow(int begin, T object) const {
+  for (int i = begin; i < _visibleItemCount; i++) {
+    const ListViewItem* listViewItem = _listViewItems[i].get();
+    if (listViewItem->hasObject() && listViewItem->getObject() == object) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+template <typename T>
+int ListView<T>::findUnusedRow(int begin, int firstVisibleIndex) const {
+  // Look for a row whose object won't be shown at any of the remaining positions.
+  int lastVisibleIndex = std::min((int) _objects.size(), firstVisibleIndex + _visibleItemCount);
+  for (int i = begin; i < _visibleItemCount; i++) {
+    const ListViewItem* listViewItem = _listViewItems[i].get();
+    if (!listViewItem->hasObject()) {
+      return i;
+    }
+    auto first = _objects.begin() + std::min(firstVisibleIndex + begin + 1, lastVisibleIndex);
+    auto last = _objects.begin() + lastVisibleIndex;
+    if (std::find(first, last, listViewItem->getObject()) == last) {
+      return i;
+    }
+  }
+  return begin;
+}
+
+
 
+template <typename T>
+const int ListView<T>::_kListViewItemHeight = 25;
 
 template <typename T>
 const int ListView<T>::ListViewItem::_kListViewIconSize = 16;
@@ -263,14 +323,22 @@ ListView<T>::ListViewItem::ListViewItem(ListView<T>* parent, float x, float y)
     : _parent(parent),
       _layout(TableLayout::create(parent->_width)),
       _background(cocos2d::ui::ImageView::create(parent->_regularBg)),
+      _highlightedBackground(cocos2d::ui::ImageView::create(parent->_highlightedBg)),
       _icon(cocos2d::ui::ImageView::create(asset_manager::kEmptyImage)),
       _label(cocos2d::Label::createWithTTF("---", asset_manager::kRegularFont, asset_manager::kRegularFontSize)),
-      _object() {
+      _iconPath(asset_manager::kEmptyImage),
+      _object(),
+      _hasObject(),
+      _isSelected() {
   _icon->setScale((float) _kListViewIconSize / kIconSize);
 
   _background->setAnchorPoint({0, 1});
+  _highlightedBackground->setAnchorPoint({0, 1});
+  _highlightedBackground->setVisible(false);
   _layout->setPosition({x, y});
   _layout->addChild(_background);
+  _layout->addChild(_highlightedBackground);
+  _highlightedBackground->setPosition(_background->getPosition());
   _layout->row(1);
 
   _layout->addChild(_icon);
@@ -285,7 +353,12 @@ ListView<T>::ListViewItem::ListViewItem(ListView<T>* parent, float x, float y)
 
 template <typename T>
 void ListView<T>::ListViewItem::setSelected(bool selected) {
-  _background->loadTexture((selected) ? _parent->_highlightedBg : _parent->_regularBg);
+  if (_isSelected == selected) {
+    return;
+  }
+  _isSelected = selected;
+  _background->setVisible(!selected);
+  _highlightedBackground->setVisible(selected);
 
   if (_parent->_setSelectedCallback) {
     _parent->_setSelectedCallback(this, selected);
@@ -297,6 +370,11 @@ void ListView<T>::ListViewItem::setVisible(bool visible) {
   _layout->setVisible(visible);
 }
 
+template <typename T>
+bool ListView<T>::ListViewItem::isVisible() const {
+  return _layout->isVisible();
+}
+
 template <typename T>
 T ListView<T>::ListViewItem::getObject() const {
   return _object;
@@ -305,12 +383,32 @@ T ListView<T>::ListViewItem::getObject() const {
 template <typename T>
 void ListView<T>::ListViewItem::setObject(T object) {
   _object = object;
+  _hasObject = true;
 
   if (_parent->_setObjectCallback) {
     _parent->_setObjectCallback(this, object);
   }
 }
 
+template <typename T>
+bool ListView<T>::ListViewItem::hasObject() const {
+  return _hasObject;
+}
+
+template <typename T>
+void ListView<T>::ListViewItem::invalidate() {
+  _hasObject = false;
+}
+
+template <typename T>
+void ListView<T>::ListViewItem::setIcon(const std::string& iconPath) {
+  if (_iconPath == iconPath) {
+    return;
+  }
+  _iconPath = iconPath;
+  _icon->loadTexture(iconPath);
+}
+
 template <typename T>
 cocos2d::ui::Layout* ListView<T>::ListViewItem::getLayout() const {
   return _layout;
@@ -1,8 +1,11 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "CommandParser.h"
 
+#include <stdexcept>
+#include <unordered_map>
+
+#include <cocos2d.h>
 #include "character/Player.h"
-#include "item/Item.h"
 #include "map/GameMapManager.h"
 #include "ui/notifications/Notifications.h"
 #include "util/StringUtil.h"
@@ -13,46 +16,73 @@
 using std::string;
 using std::vector;
 using std::out_of_range;
+using std::runtime_error;
 using std::invalid_argument;
-using CmdTable = std::unordered_map<std::string, void (vigilante::CommandParser::*)(const std::vector<std::string>&)>;
+using cocos2d::FileUtils;
+using CmdTable = std::unordered_map<std::string, vigilante::CommandParser::Command (*)(const std::vector<std::string>&)>;
 
 namespace vigilante {
 
 CommandParser::CommandParser() : _success(), _errMsg() {}
 
 void CommandParser::parse(const string& cmd, bool showNotification) {
-  vector<string> args;
-  if (cmd.empty() || (args = string_util::split(cmd)).empty()) {
-    return;
+  try {
+    execute(compile(cmd));
+    setSuccess();
+  } catch (const runtime_error& ex) {
+    setError(ex.what());
+    VGLOG(LOG_ERR, "%s", _errMsg.c_str());
   }
 
-  _success = false;
-  _errMsg = DEFAULT_ERR_MSG;
+  if (showNotification) {
+    Notifications::getInstance()->show((_success) ? cmd : _errMsg);
+  }
+}
+
+CommandParser::Command CommandParser::compile(const string& cmd) {
+  vector<string> args = string_util::split(cmd);
+  if (args.empty()) {
+    throw runtime_error(DEFAULT_ERR_MSG);
+  }
 
-  // Command handler table.
+  // Command compiler table.
   static const CmdTable cmdTable = {
-    {"startquest", &CommandParser::startQuest},
-    {"additem",    &CommandParser::addItem   },
-    {"removeitem", &CommandParser::removeItem}
+    {"startquest", &CommandParser::compileStartQuest},
+    {"additem",    &CommandParser::compileAddItem   },
+    {"removeitem", &CommandParser::compileRemoveItem}
   };
- 
-  // Execute the corresponding command handler from _cmdTable.
-  // The obtained value from _cmdTable is a class member function pointer.
+
   CmdTable::const_iterator it = cmdTable.find(args[0]);
-  if (it != cmdTable.end()) {
-    (this->*((*it).second))(args);
+  if (it == cmdTable.end()) {
+    throw runtime_error(args[0] + ": " + DEFAULT_ERR_MSG);
   }
 
-  if (!_success) {
-    _errMsg = args[0] + ": " + _errMsg;
-    VGLOG(LOG_ERR, "%s", _errMsg.c_str());
+  try {
+    return (*it).second(args);
+  } catch (const runtime_error& ex) {
+    throw runtime_error(args[0] + ": " + ex.what());
   }
+}
 
-  if (showNotification) {
-    Notifications::getInstance()->show((_success) ? cmd : _errMsg);
+void CommandParser::execute(const CommandParser::Command& cmd) {
+  Player* player = GameMapManager::getInstance()->getPlayer();
+
+  switch (cmd.opcode) {
+    case Command::Opcode::START_QUEST:
+      player->getQuestBook().startQuest(cmd.quest.str());
+      break;
+    case Command::Opcode::ADD_ITEM:
+      player->addItem(cmd.item, cmd.amount);
+      break;
+    case Command::Opcode::REMOVE_ITEM:
+      player->removeItem(cmd.item, cmd.amount);
+      break;
+    default:
+      break;
   }
 }
 
+
 void CommandParser::setSuccess() {
   _success = true;
 }
@@ -63,78 +93,49 @@ void CommandParser::setError(const string& errMsg) {
 }
 
 
-void CommandParser::startQuest(const vector<string>& args) {
+CommandParser::Command CommandParser::compileStartQuest(const vector<string>& args) {
   if (args.size() < 2) {
-    setError("missing parameter `quest`");
-    return;
+    throw runtime_error("missing parameter `quest`");
   }
-
-  GameMapManager::getInstance()->getPlayer()->getQuestBook().startQuest(args[1]);
-  setSuccess();
+  if (!FileUtils::getInstance()->isFileExist(args[1])) {
+    throw runtime_error("quest not found: " + args[1]);
+  }
+  return {Command::Opcode::START_QUEST, Atom(args[1]), nullptr, 0};
 }
 
-
-void CommandParser::addItem(const vector<string>& args) {
+CommandParser::Command CommandParser::compileAddItem(const vector<string>& args) {
   if (args.size() < 2) {
-    setError("missing parameter `itemName`");
-    return;
-  }
-
-  int amount = 1;
-  if (args.size() >= 3) {
-    try {
-      amount = std::stoi(args[2]);
-    } catch (const invalid_argument& ex) {
-      setError("invalid argument `amount`");
-      return;
-    } catch (const out_of_range& ex) {
-      setError("`amount` is too large");
-      return;
-    } catch (...) {
-      setError("unknown error");
-      return;
-    }
-  }
-
-  if (amount <= 0) {
-    setError("`amount` has to be at least 1");
-    return;
+    throw runtime_error("missing parameter `itemName`");
   }
-
-  GameMapManager::getInstance()->getPlayer()->addItem(Item::create(args[1]), amount);
-  setSuccess();
+  // Item::getPrototype() throws if there's no such item.
+  return {Command::Opcode::ADD_ITEM, Atom(), Item::getPrototype(args[1]), parseAmount(args, 2)};
 }
 
-
-void CommandParser::removeItem(const vector<string>& args) {
+CommandParser::Command CommandParser::compileRemoveItem(const vector<string>& args) {
   if (args.size() < 2) {
-    setError("missing parameter `itemName`");
-    return;
+    throw runtime_error("missing parameter `itemName`");
   }
+  return {Command::Opcode::REMOVE_ITEM, Atom(), Item::getPrototype(args[1]), parseAmount(args, 2)};
+}
 
+int CommandParser::parseAmount(const vector<string>& args, size_t idx) {
   int amount = 1;
-  if (args.size() >= 3) {
+  if (args.size() > idx) {
     try {
-      amount = std::stoi(args[2]);
+      amount = std::stoi(args[idx]);
     } catch (const invalid_argument& ex) {
-      setError("invalid argument `amount`");
-      return;
+      throw runtime_error("invalid argument `amount`");
     } catch (const out_of_range& ex) {
-      setError("`amount` is too large");
-      return;
+      throw runtime_error("`amount` is too large");
     } catch (...) {
-      setError("unknown error");
-      return;
+      throw runtime_error("unknown error");
     }
   }
 
   if (amount <= 0) {
-    setError("`amount` has to be at least 1");
-    return;
+    throw runtime_error("`amount` has to be at least 1");
   }
-
-  GameMapManager::getInstance()->getPlayer()->removeItem(Item::create(args[1]), amount);
-  setSuccess();
+  return amount;
 }
 
 } // namespace vigilante
@@ -4,25 +4,49 @@
 
 #include <string>
 #include <vector>
-#include <unordered_map>
+
+#include "item/Item.h"
+#include "util/Atom.h"
 
 namespace vigilante {
 
 class CommandParser {
  public:
+  // A command line compiled ahead of time, e.g., "additem <itemJson> 3".
+  // Its arguments are validated and resolved, so executing it is just a switch.
+  struct Command {
+    enum Opcode {
+      START_QUEST,
+      ADD_ITEM,
+      REMOVE_ITEM
+    };
+
+    CommandParser::Command::Opcode opcode;
+    Atom quest; // START_QUEST: the quest json
+    const Item* item; // ADD_ITEM, REMOVE_ITEM
+    int amount; // ADD_ITEM, REMOVE_ITEM
+  };
+
   CommandParser();
   virtual ~CommandParser() = default;
 
+  // Compiles and executes a line typed into the console.
   void parse(const std::string& cmd, bool showNotification);
 
+  // Throws std::runtime_error if the line is malformed, so the commands
+  // in game data (e.g., dialogue trees) fail at load time instead.
+  static CommandParser::Command compile(const std::string& cmd);
+  static void execute(const CommandParser::Command& cmd);
+
  private:
   void setSuccess();
   void setError(const std::string& errMsg);
 
-  // Command handlers.
-  void startQuest(const std::vector<std::string>& args);
-  void addItem(const std::vector<std::string>& args);
-  void removeItem(const std::vector<std::string>& args);
+  // Command compilers.
+  static CommandParser::Command compileStartQuest(const std::vector<std::string>& args);
+  static CommandParser::Command compileAddItem(const std::vector<std::string>& args);
+  static CommandParser::Command compileRemoveItem(const std::vector<std::string>& args);
+  static int parseAmount(const std::vector<std::string>& args, size_t idx);
 
   bool _success;
   std::string _errMsg;
@@ -3,7 +3,7 @@
 
 #include "AssetManager.h"
 #include "gameplay/DialogueTree.h"
-#include "ui/console/Console.h"
+#include "ui/console/CommandParser.h"
 #include "ui/dialogue/DialogueManager.h"
 #include "ui/dialogue/DialogueListView.h"
 
@@ -15,14 +15,14 @@
 namespace vigilante {
 
 DialogueListView::DialogueListView(DialogueMenu* dialogMenu)
-    : ListView<Dialogue*>(VISIBLE_ITEM_COUNT, WIDTH, REGULAR_BG, HIGHLIGHTED_BG),
+    : ListView<const Dialogue*>(VISIBLE_ITEM_COUNT, WIDTH, REGULAR_BG, HIGHLIGHTED_BG),
       _dialogueMenu(dialogMenu) {
 
   _setSelectedCallback = [](ListView::ListViewItem* listViewItem, bool selected) {
-    listViewItem->getIcon()->loadTexture((selected) ? asset_manager::kDialogueTriangle : asset_manager::kEmptyImage);
+    listViewItem->setIcon((selected) ? asset_manager::kDialogueTriangle : asset_manager::kEmptyImage);
   };
 
-  _setObjectCallback = [](ListView::ListViewItem* listViewItem, Dialogue* dialogue) {
+  _setObjectCallback = [](ListView::ListViewItem* listViewItem, const Dialogue* dialogue) {
     listViewItem->getLabel()->setString(dialogue->lines.front());
   };
 
@@ -36,10 +36,10 @@ void DialogueListView::confirm() {
   auto subtitles = dialogueMgr->getSubtitles();
 
   for (const auto& cmd : getSelectedObject()->cmds) {
-    Console::getInstance()->executeCmd(cmd);
+    CommandParser::execute(cmd);
   }
   
-  Dialogue* nextDialogue = getSelectedObject()->children.front();
+  const Dialogue* nextDialogue = &getSelectedObject()->children.front();
   for (const auto& line : nextDialogue->lines) {
     subtitles->addSubtitle(line);
   }
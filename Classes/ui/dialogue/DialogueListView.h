@@ -15,7 +15,7 @@ class DialogueMenu;
 
 using Dialogue = DialogueTree::Node;
 
-class DialogueListView : public ListView<Dialogue*> {
+class DialogueListView : public ListView<const Dialogue*> {
  public:
   explicit DialogueListView(DialogueMenu* dialogueMenu);
   virtual ~DialogueListView() = default;
@@ -53,8 +53,8 @@ DialogueMenu* DialogueManager::getDialogueMenu() const {
   return _dialogueMenu.get();
 }
 
-Dialogue* DialogueManager::getCurrentDialogue() const {
-  return (_targetNpc) ? _targetNpc->getDialogueTree().getCurrentNode() : nullptr;
+const Dialogue* DialogueManager::getCurrentDialogue() const {
+  return (_targetNpc) ? _targetNpc->getCurrentDialogue() : nullptr;
 }
 
 
@@ -62,11 +62,11 @@ void DialogueManager::setTargetNpc(Npc* npc) {
   _targetNpc = npc;
 }
 
-void DialogueManager::setCurrentDialogue(Dialogue* dialogue) const {
+void DialogueManager::setCurrentDialogue(const Dialogue* dialogue) const {
   if (!_targetNpc) {
     return;
   }
-  _targetNpc->getDialogueTree().setCurrentNode(dialogue);
+  _targetNpc->setCurrentDialogue(dialogue);
 }
 
 } // namespace vigilante
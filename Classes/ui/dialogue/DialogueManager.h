@@ -25,10 +25,10 @@ class DialogueManager : public Controllable {
   Npc* getTargetNpc() const;
   Subtitles* getSubtitles() const;
   DialogueMenu* getDialogueMenu() const;
-  Dialogue* getCurrentDialogue() const;
+  const Dialogue* getCurrentDialogue() const;
 
   void setTargetNpc(Npc* npc);
-  void setCurrentDialogue(Dialogue* dialogue) const;
+  void setCurrentDialogue(const Dialogue* dialogue) const;
 
  private:
   static DialogueManager* _instance;
@@ -3,7 +3,7 @@
 
 #include "AssetManager.h"
 #include "input/InputManager.h"
-#include "ui/console/Console.h"
+#include "ui/console/CommandParser.h"
 #include "ui/dialogue/DialogueManager.h"
 #include "ui/hud/Hud.h"
 
@@ -12,6 +12,7 @@
 #define SUBTITLES_Y 38
 
 using std::string;
+using std::vector;
 using std::queue;
 using cocos2d::Director;
 using cocos2d::Layer;
@@ -143,17 +144,21 @@ void Subtitles::showNextSubtitle() {
   // If all subtitles has been displayed, show DialogueMenu if possible.
   DialogueManager* dialogueMgr = DialogueManager::getInstance();
   DialogueMenu* dialogueMenu = dialogueMgr->getDialogueMenu();
-  Dialogue* currentDialogue = dialogueMgr->getCurrentDialogue();
+  const Dialogue* currentDialogue = dialogueMgr->getCurrentDialogue();
 
   for (const auto& cmd : currentDialogue->cmds) {
-    Console::getInstance()->executeCmd(cmd);
+    CommandParser::execute(cmd);
   }
 
   if (currentDialogue->children.empty()) { // end of dialogue
     endSubtitles();
-    dialogueMgr->getTargetNpc()->getDialogueTree().resetCurrentNode();
+    dialogueMgr->getTargetNpc()->resetCurrentDialogue();
   } else { // still has children dialogue
-    dialogueMenu->getDialogueListView()->setObjects(currentDialogue->children);
+    vector<const Dialogue*> children;
+    for (const auto& child : currentDialogue->children) {
+      children.push_back(&child);
+    }
+    dialogueMenu->getDialogueListView()->setObjects(children);
     dialogueMenu->getLayer()->setVisible(true);
   }
 }
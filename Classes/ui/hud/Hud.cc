@@ -63,9 +63,24 @@ Hud::Hud()
 }
 
 
+void Hud::update(float delta) {
+  if (!_player) {
+    return;
+  }
+
+  Character::Profile& profile = _player->getCharacterProfile();
+  _healthBar->setValue(profile.health, profile.fullHealth);
+  _magickaBar->setValue(profile.magicka, profile.fullMagicka);
+  _staminaBar->setValue(profile.stamina, profile.fullStamina);
+
+  _healthBar->update(delta);
+  _magickaBar->update(delta);
+  _staminaBar->update(delta);
+}
+
 void Hud::updateEquippedWeapon() {
   // Update equipped weapon.
-  Equipment* weapon = _player->getEquipmentSlots()[Equipment::Type::WEAPON];
+  const Equipment* weapon = _player->getEquipmentSlots()[Equipment::Type::WEAPON];
   if (weapon) {
     // Replace weapon icon
     _equippedWeapon->loadTexture(weapon->getIconPath());
@@ -79,13 +94,6 @@ void Hud::updateEquippedWeapon() {
   }
 }
 
-void Hud::updateStatusBars() {
-  // Update status bars.
-  Character::Profile& profile = _player->getCharacterProfile();
-  _healthBar->update(profile.health, profile.fullHealth);
-  _magickaBar->update(profile.magicka, profile.fullMagicka);
-  _staminaBar->update(profile.stamina, profile.fullStamina);
-}
 
 
 Layer* Hud::getLayer() const {
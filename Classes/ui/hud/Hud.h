@@ -18,8 +18,10 @@ class Hud {
   static Hud* getInstance();
   virtual ~Hud() = default;
 
+  // Syncs the status bars with the player's health, magicka and stamina,
+  // once per frame. Only the bars whose values have changed are updated.
+  void update(float delta);
   void updateEquippedWeapon();
-  void updateStatusBars();
 
   cocos2d::Layer* getLayer() const;
   void setPlayer(Player* player);
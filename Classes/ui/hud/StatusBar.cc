@@ -1,12 +1,17 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "StatusBar.h"
 
+#include <cmath>
+#include <algorithm>
+
 using std::string;
 using cocos2d::ui::Layout;
 using cocos2d::ui::ImageView;
 
 namespace vigilante {
 
+const float StatusBar::_kLerpSpeed = 10.0f;
+
 StatusBar::StatusBar(const string& leftPaddingImgPath,
                      const string& rightPaddingImgPath,
                      const string& statusBarImgPath,
@@ -15,7 +20,11 @@ StatusBar::StatusBar(const string& leftPaddingImgPath,
       _leftPaddingImg(ImageView::create(leftPaddingImgPath)),
       _rightPaddingImg(ImageView::create(rightPaddingImgPath)),
       _statusBarImg(ImageView::create(statusBarImgPath)),
-      _maxLength(maxLength) {
+      _maxLength(maxLength),
+      _length(maxLength),
+      _targetLength(maxLength),
+      _currentVal(),
+      _fullVal() {
   _leftPaddingImg->setAnchorPoint({0, 0});
   _rightPaddingImg->setAnchorPoint({0, 0});
   _statusBarImg->setAnchorPoint({0, 0});
@@ -28,9 +37,32 @@ StatusBar::StatusBar(const string& leftPaddingImgPath,
 }
 
 
-void StatusBar::update(int currentVal, int fullVal) {
-  _statusBarImg->setScaleX(_maxLength * currentVal / fullVal);
-  _rightPaddingImg->setPositionX(_statusBarImg->getPositionX() + _maxLength * currentVal / fullVal);
+void StatusBar::setValue(int currentVal, int fullVal) {
+  if (currentVal == _currentVal && fullVal == _fullVal) {
+    return;
+  }
+  _currentVal = currentVal;
+  _fullVal = fullVal;
+  _targetLength = (fullVal > 0) ? _maxLength * currentVal / fullVal : 0;
+}
+
+void StatusBar::update(float delta) {
+  if (_length == _targetLength) {
+    return;
+  }
+
+  float diff = _targetLength - _length;
+  if (std::abs(diff) < .5f) {
+    setLength(_targetLength);
+  } else {
+    setLength(_length + diff * std::min(1.0f, delta * _kLerpSpeed));
+  }
+}
+
+void StatusBar::setLength(float length) {
+  _length = length;
+  _statusBarImg->setScaleX(length);
+  _rightPaddingImg->setPositionX(_statusBarImg->getPositionX() + length);
 }
 
 
@@ -17,16 +17,28 @@ class StatusBar {
             const std::string& statusBarImgPath,
             float maxLength);
   virtual ~StatusBar() = default;
-  void update(int currentVal, int fullVal);
+
+  // Sets the value to be shown. This is cheap if the value hasn't changed,
+  // and the bar is animated towards it in update().
+  void setValue(int currentVal, int fullVal);
+  void update(float delta);
 
   cocos2d::ui::Layout* getLayout() const;
 
  private:
+  void setLength(float length);
+
+  static const float _kLerpSpeed;
+
   cocos2d::ui::Layout* _layout;
   cocos2d::ui::ImageView* _leftPaddingImg;
   cocos2d::ui::ImageView* _rightPaddingImg;
   cocos2d::ui::ImageView* _statusBarImg;
   const float _maxLength;
+  float _length;
+  float _targetLength;
+  int _currentVal;
+  int _fullVal;
 };
 
 } // namespace vigilante
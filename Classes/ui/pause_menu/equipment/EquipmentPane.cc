@@ -26,7 +26,8 @@ namespace vigilante {
 EquipmentPane::EquipmentPane(PauseMenu* pauseMenu)
     : AbstractPane(pauseMenu, TableLayout::create(300)),
       _inputMgr(InputManager::getInstance()),
-      _current() {
+      _current(),
+      _shownEquipmentVersion() {
   Layout* innerLayout = Layout::create();
 
   for (int i = 0; i < Equipment::Type::SIZE; i++) {
@@ -43,10 +44,16 @@ EquipmentPane::EquipmentPane(PauseMenu* pauseMenu)
 }
 
 void EquipmentPane::update() {
-  const Character::EquipmentSlots& slots = _pauseMenu->getPlayer()->getEquipmentSlots();
+  Player* player = _pauseMenu->getPlayer();
+  if (player->getEquipmentVersion() == _shownEquipmentVersion) {
+    return;
+  }
+  _shownEquipmentVersion = player->getEquipmentVersion();
+
+  const Character::EquipmentSlots& slots = player->getEquipmentSlots();
 
   for (int i = 0; i < Equipment::Type::SIZE; i++) {
-    Equipment* equipment = slots[i];
+    const Equipment* equipment = slots[i];
     _equipmentItems[i]->setEquipment(equipment);
   }
 }
@@ -86,7 +93,7 @@ void EquipmentPane::confirm() {
   inventoryPane->selectEquipment(getSelectedEquipmentType());
 }
 
-Equipment* EquipmentPane::getSelectedEquipment() const {
+const Equipment* EquipmentPane::getSelectedEquipment() const {
   return _equipmentItems[_current]->getEquipment();
 }
 
@@ -126,11 +133,11 @@ EquipmentPane::EquipmentItem::EquipmentItem(EquipmentPane* parent, const string&
   _layout->align(TableLayout::Alignment::CENTER)->padTop(1);
 }
 
-Equipment* EquipmentPane::EquipmentItem::getEquipment() const {
+const Equipment* EquipmentPane::EquipmentItem::getEquipment() const {
   return _equipment;
 }
 
-void EquipmentPane::EquipmentItem::setEquipment(Equipment* equipment) {
+void EquipmentPane::EquipmentItem::setEquipment(const Equipment* equipment) {
   _equipment = equipment;
 
   if (equipment) {
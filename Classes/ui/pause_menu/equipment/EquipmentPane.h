@@ -29,7 +29,7 @@ class EquipmentPane : public AbstractPane {
   void selectDown();
   void confirm();
 
-  Equipment* getSelectedEquipment() const;
+  const Equipment* getSelectedEquipment() const;
   Equipment::Type getSelectedEquipmentType() const;
 
  private:
@@ -39,8 +39,8 @@ class EquipmentPane : public AbstractPane {
     EquipmentItem(EquipmentPane* parent, const std::string& title, float x, float y);
     virtual ~EquipmentItem() = default;
 
-    Equipment* getEquipment() const;
-    void setEquipment(Equipment* equipment);
+    const Equipment* getEquipment() const;
+    void setEquipment(const Equipment* equipment);
 
     void setSelected(bool selected) const;
     cocos2d::ui::Layout* getLayout() const;
@@ -54,12 +54,13 @@ class EquipmentPane : public AbstractPane {
     cocos2d::ui::ImageView* _icon;
     cocos2d::Label* _equipmentTypeLabel;
     cocos2d::Label* _equipmentNameLabel;
-    Equipment* _equipment;
+    const Equipment* _equipment;
   };
 
   InputManager* _inputMgr;
   std::vector<std::unique_ptr<EquipmentItem>> _equipmentItems;
   int _current;
+  uint32_t _shownEquipmentVersion; // so update() only refreshes the slots when they change
 };
 
 } // namespace vigilante
@@ -69,7 +69,7 @@ void InventoryPane::handleInput() {
     } else {
       // If currently the inventory pane is in equipment selection mode,
       // get the selected item, and set it as the new equipment.
-      Equipment* equipment = dynamic_cast<Equipment*>(_itemListView->getSelectedObject());
+      const Equipment* equipment = dynamic_cast<const Equipment*>(_itemListView->getSelectedObject().item);
       if (equipment) {
         _pauseMenu->getPlayer()->equip(equipment);
       } else {
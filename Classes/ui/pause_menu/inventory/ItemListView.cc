@@ -4,7 +4,7 @@
 #include "AssetManager.h"
 #include "Constants.h"
 #include "character/Player.h"
-#include "input/Keybindable.h"
+#include "input/HotkeyManager.h"
 #include "item/Item.h"
 #include "item/Consumable.h"
 #include "ui/pause_menu/PauseMenu.h"
@@ -26,43 +26,47 @@ using std::deque;
 using std::vector;
 using std::string;
 using cocos2d::Label;
+using cocos2d::EventKeyboard;
 using cocos2d::ui::ImageView;
 
 namespace vigilante {
 
 ItemListView::ItemListView(PauseMenu* pauseMenu)
-    : ListView<Item*>(VISIBLE_ITEM_COUNT, WIDTH, REGULAR_BG, HIGHLIGHTED_BG),
+    : ListView<Character::ItemStack>(VISIBLE_ITEM_COUNT, WIDTH, REGULAR_BG, HIGHLIGHTED_BG),
       _pauseMenu(pauseMenu),
-      _descLabel(Label::createWithTTF("", asset_manager::kRegularFont, asset_manager::kRegularFontSize)) {
+      _descLabel(Label::createWithTTF("", asset_manager::kRegularFont, asset_manager::kRegularFontSize)),
+      _shownItemType(Item::Type::SIZE),
+      _shownInventoryVersion(),
+      _shownHotkeyVersion() {
 
   // _setObjectCallback is called at the end of ListView<T>::ListViewItem::setObject()
   // see ui/ListView.h
-  _setObjectCallback = [](ListViewItem* listViewItem, Item* item) {
-    ImageView* icon = listViewItem->getIcon();
+  _setObjectCallback = [](ListViewItem* listViewItem, Character::ItemStack itemStack) {
     Label* label = listViewItem->getLabel();
+    const Item* item = itemStack.item;
 
-    icon->loadTexture((item) ? item->getIconPath() : EMPTY_ITEM_ICON);
-    label->setString((item) ? item->getName() : EMPTY_ITEM_NAME);
+    listViewItem->setIcon((item) ? item->getIconPath() : EMPTY_ITEM_ICON);
 
     if (!item) {
+      label->setString(EMPTY_ITEM_NAME);
       return;
     }
 
+    // Build the whole label text first, so the label is only updated once.
+    string text = item->getName();
+
     // Display item amount if amount > 1
-    if (item->getAmount() > 1) {
-      Label* label = listViewItem->getLabel();
-      label->setString(label->getString() + " (" + std::to_string(item->getAmount()) + ")");
+    if (itemStack.amount > 1) {
+      text.append(" (").append(std::to_string(itemStack.amount)).append(")");
     }
 
     // Display consumable's hotkey (if defined).
-    // Consumables are Keybindable, see item/Consumable.h
-    Keybindable* keybindable = dynamic_cast<Keybindable*>(item);
-    bool hasDefinedHotkey = keybindable && static_cast<bool>(keybindable->getHotkey());
-
-    if (hasDefinedHotkey) {
-      const string& hotkey = keycode_util::keyCodeToString(keybindable->getHotkey());
-      label->setString(label->getString() + " [" + hotkey + "]");
+    // It's kept in the stack, see Character::ItemStack
+    if (static_cast<bool>(itemStack.hotkey)) {
+      text.append(" [").append(keycode_util::keyCodeToString(itemStack.hotkey)).append("]");
     }
+
+    label->setString(text);
   };
 
   _descLabel->getFontAtlas()->setAliasTexParameters();
@@ -74,7 +78,7 @@ ItemListView::ItemListView(PauseMenu* pauseMenu)
 
 
 void ItemListView::confirm() {
-  Item* item = getSelectedObject();
+  const Item* item = getSelectedObject().item;
   if (!item) {
     return;
   }
@@ -86,13 +90,13 @@ void ItemListView::confirm() {
   switch (item->getItemProfile().itemType) {
     case Item::Type::EQUIPMENT:
       dialog->setOption(0, true, "Equip", [=]() {
-        _pauseMenu->getPlayer()->equip(dynamic_cast<Equipment*>(item));
+        _pauseMenu->getPlayer()->equip(dynamic_cast<const Equipment*>(item));
         _pauseMenu->update();
       });
       break;
     case Item::Type::CONSUMABLE:
       dialog->setOption(0, true, "Use", [=]() {
-        _pauseMenu->getPlayer()->useItem(dynamic_cast<Consumable*>(item));
+        _pauseMenu->getPlayer()->useItem(dynamic_cast<const Consumable*>(item));
         _pauseMenu->update();
       });
       break;
@@ -111,57 +115,69 @@ void ItemListView::confirm() {
 
 
 void ItemListView::selectUp() {
-  ListView<Item*>::selectUp();
+  ListView<Character::ItemStack>::selectUp();
   
   if (_current <= 0) {
     return;
   }
 
-  Item* selectedItem = _objects[_current];
+  const Item* selectedItem = _objects[_current].item;
   _descLabel->setString((selectedItem) ? selectedItem->getDesc() : "Unequip");
 }
 
 void ItemListView::selectDown() {
-  ListView<Item*>::selectDown();
+  ListView<Character::ItemStack>::selectDown();
 
   if (_current >= (int) _objects.size() - 1) {
     return;
   }
 
-  Item* selectedItem = _objects[_current];
+  const Item* selectedItem = _objects[_current].item;
   _descLabel->setString((selectedItem) ? selectedItem->getDesc() : "Unequip");
 }
 
 
 void ItemListView::showItemsByType(Item::Type itemType) {
+  Player* player = _pauseMenu->getPlayer();
+  uint32_t inventoryVersion = player->getInventoryVersion();
+  uint32_t hotkeyVersion = HotkeyManager::getInstance()->getVersion();
+  if (itemType == _shownItemType && inventoryVersion == _shownInventoryVersion
+      && hotkeyVersion == _shownHotkeyVersion) {
+    return;
+  }
+  _shownItemType = itemType;
+  _shownInventoryVersion = inventoryVersion;
+  _shownHotkeyVersion = hotkeyVersion;
+
   // Show items of the specified type in ItemListView.
-  setObjects(_pauseMenu->getPlayer()->getInventory()[itemType]);
+  setObjects(player->getInventory()[itemType]);
 
   // Update description label.
-  _descLabel->setString((_objects.size() > 0) ? _objects[_current]->getDesc() : "");
+  _descLabel->setString((_objects.size() > 0) ? _objects[_current].item->getDesc() : "");
 }
 
 void ItemListView::showEquipmentByType(Equipment::Type equipmentType) {
-  const vector<Item*> equipments = _pauseMenu->getPlayer()->getInventory()[Item::Type::EQUIPMENT];
-  deque<Item*> objects(equipments.begin(), equipments.end());
+  const vector<Character::ItemStack>& equipments = _pauseMenu->getPlayer()->getInventory()[Item::Type::EQUIPMENT];
+  deque<Character::ItemStack> objects(equipments.begin(), equipments.end());
 
   // Filter out any equipment other than the specified equipmentType.
-  objects.erase(std::remove_if(objects.begin(), objects.end(), [=](Item* i) {
-    return dynamic_cast<Equipment*>(i)->getEquipmentProfile().equipmentType != equipmentType;
+  objects.erase(std::remove_if(objects.begin(), objects.end(), [=](const Character::ItemStack& s) {
+    return static_cast<const Equipment*>(s.item)->getEquipmentProfile().equipmentType != equipmentType;
   }), objects.end());
 
   // Currently this method is only used for selecting equipment,
   // so here we're going to push_front two extra equipment.
   Character* character = _pauseMenu->getPlayer();
-  Equipment* currentEquipment = character->getEquipmentSlots()[equipmentType];
+  const Equipment* currentEquipment = character->getEquipmentSlots()[equipmentType];
 
   if (currentEquipment) {
-    objects.push_front(currentEquipment); // currently equipped item
-    objects.push_front(nullptr); // unequip
+    objects.push_front({currentEquipment, 1, EventKeyboard::KeyCode::KEY_NONE}); // currently equipped item
+    objects.push_front(Character::ItemStack()); // unequip
   }
 
   // Show equipments of the specified type in ItemListView.
   setObjects(objects);
+  _shownItemType = Item::Type::SIZE;
 
   // Update description label. The first item is an empty item,
   // Selecting it will unequip current equipment.
@@ -2,6 +2,7 @@
 #ifndef VIGILANTE_ITEM_LIST_VIEW_H_
 #define VIGILANTE_ITEM_LIST_VIEW_H_
 
+#include "character/Character.h"
 #include "item/Item.h"
 #include "item/Equipment.h"
 #include "ui/ListView.h"
@@ -10,14 +11,16 @@ namespace vigilante {
 
 class PauseMenu;
 
-class ItemListView : public ListView<Item*> {
+// Shows the item stacks of the player. A stack without an item means "Unequip"
+// (see showEquipmentByType()).
+class ItemListView : public ListView<Character::ItemStack> {
  public:
   explicit ItemListView(PauseMenu* pauseMenu);
   virtual ~ItemListView() = default;
 
-  virtual void confirm() override; // ListView<Item*>
-  virtual void selectUp() override; // ListView<Item*>
-  virtual void selectDown() override; // ListView<Item*>
+  virtual void confirm() override; // ListView<Character::ItemStack>
+  virtual void selectUp() override; // ListView<Character::ItemStack>
+  virtual void selectDown() override; // ListView<Character::ItemStack>
 
   void showItemsByType(Item::Type itemType);
   void showEquipmentByType(Equipment::Type equipmentType);
@@ -25,6 +28,11 @@ class ItemListView : public ListView<Item*> {
  private:
   PauseMenu* _pauseMenu;
   cocos2d::Label* _descLabel;
+
+  // What showItemsByType() has shown, so it only rebuilds the list when these change.
+  Item::Type _shownItemType; // Item::Type::SIZE if showing equipment (see showEquipmentByType())
+  uint32_t _shownInventoryVersion;
+  uint32_t _shownHotkeyVersion;
 };
 
 } // namespace vigilante
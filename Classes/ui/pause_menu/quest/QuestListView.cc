@@ -22,7 +22,8 @@ namespace vigilante {
 QuestListView::QuestListView(PauseMenu* pauseMenu)
     : ListView<Quest*>(VISIBLE_ITEM_COUNT, WIDTH, REGULAR_BG, HIGHLIGHTED_BG),
       _pauseMenu(pauseMenu),
-      _descLabel(Label::createWithTTF("", asset_manager::kRegularFont, asset_manager::kRegularFontSize)) {
+      _descLabel(Label::createWithTTF("", asset_manager::kRegularFont, asset_manager::kRegularFontSize)),
+      _shownQuestBookVersion() {
 
   // _setObjectCallback is called at the end of ListView<T>::ListViewItem::setObject()
   // see ui/ListView.h
@@ -102,6 +103,11 @@ void QuestListView::selectDown() {
 void QuestListView::showQuests() {
   // Show player skills in QuestListView.
   Player* player = _pauseMenu->getPlayer();
+  uint32_t questBookVersion = player->getQuestBook().getVersion();
+  if (questBookVersion == _shownQuestBookVersion) {
+    return;
+  }
+  _shownQuestBookVersion = questBookVersion;
   setObjects(player->getQuestBook().getAllQuests());
 
   // Update description label.
@@ -25,6 +25,8 @@ class QuestListView : public ListView<Quest*> {
  private:
   PauseMenu* _pauseMenu;
   cocos2d::Label* _descLabel;
+
+  uint32_t _shownQuestBookVersion; // so showQuests() only rebuilds the list when it changes
 };
 
 } // namespace vigilante
@@ -27,17 +27,18 @@ namespace vigilante {
 SkillListView::SkillListView(PauseMenu* pauseMenu)
     : ListView<Skill*>(VISIBLE_ITEM_COUNT, WIDTH, REGULAR_BG, HIGHLIGHTED_BG),
       _pauseMenu(pauseMenu),
-      _descLabel(Label::createWithTTF("", asset_manager::kRegularFont, asset_manager::kRegularFontSize)) {
+      _descLabel(Label::createWithTTF("", asset_manager::kRegularFont, asset_manager::kRegularFontSize)),
+      _shownSkillsVersion(),
+      _shownHotkeyVersion() {
 
   // _setObjectCallback is called at the end of ListView<T>::ListViewItem::setObject()
   // see ui/ListView.h
   _setObjectCallback = [](ListViewItem* listViewItem, Skill* skill) {
     assert(skill != nullptr);
 
-    ImageView* icon = listViewItem->getIcon();
     Label* label = listViewItem->getLabel();
 
-    icon->loadTexture(skill->getIconPath());
+    listViewItem->setIcon(skill->getIconPath());
     label->setString(skill->getName());
 
     // Display skill hotkey (if defined).
@@ -115,8 +116,17 @@ void SkillListView::selectDown() {
 
 
 void SkillListView::showSkills() {
+  Player* player = _pauseMenu->getPlayer();
+  uint32_t skillsVersion = player->getSkillsVersion();
+  uint32_t hotkeyVersion = HotkeyManager::getInstance()->getVersion();
+  if (skillsVersion == _shownSkillsVersion && hotkeyVersion == _shownHotkeyVersion) {
+    return;
+  }
+  _shownSkillsVersion = skillsVersion;
+  _shownHotkeyVersion = hotkeyVersion;
+
   // Show player skills in SkillListView.
-  setObjects(_pauseMenu->getPlayer()->getSkills());
+  setObjects(player->getSkills());
 
   // Update description label.
   _descLabel->setString((_objects.size() > 0) ? _objects[_current]->getDesc() : "");
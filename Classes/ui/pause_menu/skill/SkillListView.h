@@ -25,6 +25,10 @@ class SkillListView : public ListView<Skill*> {
  private:
   PauseMenu* _pauseMenu;
   cocos2d::Label* _descLabel;
+
+  // What showSkills() has shown, so it only rebuilds the list when these change.
+  uint32_t _shownSkillsVersion;
+  uint32_t _shownHotkeyVersion;
 };
 
 } // namespace vigilante
@@ -0,0 +1,73 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "Atom.h"
+
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+using std::mutex;
+using std::string;
+using std::lock_guard;
+using std::unordered_map;
+using std::runtime_error;
+
+namespace {
+
+// The intern table. Atoms can be created from any thread (e.g., the bot workers).
+// References to the strings stay valid, since unordered_map never moves its nodes.
+struct InternTable {
+  mutex mtx;
+  unordered_map<vigilante::Atom::Id, string> strings;
+};
+
+// Function-local, so that atoms can be used to initialize other static constants.
+InternTable& getInternTable() {
+  static InternTable table = {{}, {{vigilante::atom_util::hash(""), ""}}};
+  return table;
+}
+
+vigilante::Atom::Id intern(const char* s, size_t length) {
+  // Same as atom_util::hash(), but iterative.
+  vigilante::Atom::Id id = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    id = (id ^ static_cast<uint8_t>(s[i])) * 16777619u;
+  }
+
+  InternTable& table = getInternTable();
+  lock_guard<mutex> lock(table.mtx);
+  auto it = table.strings.find(id);
+  if (it == table.strings.end()) {
+    table.strings.insert({id, string(s, length)});
+  } else if (it->second.compare(0, string::npos, s, length) != 0) {
+    throw runtime_error("Atom collision: \"" + it->second + "\" and \"" + string(s, length) + "\"");
+  }
+  return id;
+}
+
+} // namespace
+
+
+namespace vigilante {
+
+Atom::Atom() : _id(atom_util::hash("")) {}
+
+Atom::Atom(const string& s) : _id(::intern(s.c_str(), s.size())) {}
+
+Atom::Atom(const char* s) : _id(::intern(s, std::char_traits<char>::length(s))) {}
+
+
+const string& Atom::str() const {
+  InternTable& table = ::getInternTable();
+  lock_guard<mutex> lock(table.mtx);
+  return table.strings.at(_id);
+}
+
+Atom::Id Atom::getId() const {
+  return _id;
+}
+
+bool Atom::empty() const {
+  return _id == atom_util::hash("");
+}
+
+} // namespace vigilante
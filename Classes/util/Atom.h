@@ -0,0 +1,69 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_ATOM_H_
+#define VIGILANTE_ATOM_H_
+
+#include <cstdint>
+#include <string>
+#include <functional>
+
+#include "util/FlatMap.h"
+
+namespace vigilante {
+
+namespace atom_util {
+
+// 32-bit FNV-1a. Being constexpr, it computes the id of
+// a string literal at compile time, e.g., case atom_util::hash("slime"):
+constexpr uint32_t hash(const char* s, uint32_t h=2166136261u) {
+  return (*s) ? hash(s + 1, (h ^ static_cast<uint8_t>(*s)) * 16777619u) : h;
+}
+
+} // namespace atom_util
+
+
+// An Atom is a 32-bit handle to an interned string (a name, an asset path,
+// a frames name, ...). Comparing, hashing and copying atoms costs as much
+// as doing so with an int, so caches and lookups on hot paths are keyed by
+// atoms, and strings are only built for file IO and display.
+//
+// The id of an atom is the hash of its string (see atom_util::hash()),
+// so the same string always maps to the same id, even across runs.
+// Two strings with the same hash are detected when interned.
+class Atom {
+ public:
+  using Id = uint32_t;
+
+  Atom(); // the empty string
+  explicit Atom(const std::string& s);
+  explicit Atom(const char* s);
+
+  const std::string& str() const;
+  Atom::Id getId() const;
+  bool empty() const;
+
+  bool operator== (Atom other) const { return _id == other._id; }
+  bool operator!= (Atom other) const { return _id != other._id; }
+  bool operator< (Atom other) const { return _id < other._id; }
+
+ private:
+  Atom::Id _id;
+};
+
+template <typename T>
+using AtomMap = FlatMap<Atom, T>;
+
+} // namespace vigilante
+
+
+namespace std {
+
+template <>
+struct hash<vigilante::Atom> {
+  size_t operator() (vigilante::Atom atom) const {
+    return atom.getId();
+  }
+};
+
+} // namespace std
+
+#endif // VIGILANTE_ATOM_H_
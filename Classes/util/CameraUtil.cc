@@ -85,8 +85,8 @@ void updateShake(Camera* camera, float delta) {
 
   if (::currentTime <= ::duration) {
     ::currentPower = ::power * ((::duration - ::currentTime) / ::duration);
-    ::pos.x = (rand_util::randFloat() - 0.5f) * 2 * ::currentPower; // camera offset X
-    ::pos.y = (rand_util::randFloat() - 0.5f) * 2 * ::currentPower; // camera offset Y
+    ::pos.x = (rand_util::randFloat(0.0f, 1.0f, rand_util::Stream::COSMETIC) - 0.5f) * 2 * ::currentPower; // camera offset X
+    ::pos.y = (rand_util::randFloat(0.0f, 1.0f, rand_util::Stream::COSMETIC) - 0.5f) * 2 * ::currentPower; // camera offset Y
     ::currentTime += delta;
     // Translate camera
     const Vec2& camPos = camera->getPosition();
@@ -0,0 +1,113 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_FLAT_MAP_H_
+#define VIGILANTE_FLAT_MAP_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace vigilante {
+
+// A map stored as a vector of (key, value) pairs sorted by key.
+//
+// Lookups are a binary search over contiguous memory, and there's no per-node
+// allocation, so it beats unordered_map for the small, read-mostly caches
+// keyed by ints or atoms. Insertion/erasure is O(n), and invalidates
+// pointers/iterators to the values.
+template <typename K, typename T>
+class FlatMap {
+ public:
+  using value_type = std::pair<K, T>;
+  using iterator = typename std::vector<value_type>::iterator;
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+
+  FlatMap() = default;
+  virtual ~FlatMap() = default;
+
+  // Returns nullptr if there's no such key.
+  T* find(const K& key);
+  const T* find(const K& key) const;
+  // Inserts a value-initialized T if there's no such key.
+  T& operator[] (const K& key);
+  // Returns false if there's no such key.
+  bool erase(const K& key);
+  void clear();
+
+  size_t size() const;
+  bool empty() const;
+
+  iterator begin() { return _entries.begin(); }
+  iterator end() { return _entries.end(); }
+  const_iterator begin() const { return _entries.begin(); }
+  const_iterator end() const { return _entries.end(); }
+
+ private:
+  iterator lowerBound(const K& key);
+  const_iterator lowerBound(const K& key) const;
+
+  std::vector<value_type> _entries;
+};
+
+
+
+template <typename K, typename T>
+T* FlatMap<K, T>::find(const K& key) {
+  iterator it = lowerBound(key);
+  return (it != _entries.end() && !(key < it->first)) ? &it->second : nullptr;
+}
+
+template <typename K, typename T>
+const T* FlatMap<K, T>::find(const K& key) const {
+  const_iterator it = lowerBound(key);
+  return (it != _entries.end() && !(key < it->first)) ? &it->second : nullptr;
+}
+
+template <typename K, typename T>
+T& FlatMap<K, T>::operator[] (const K& key) {
+  iterator it = lowerBound(key);
+  if (it == _entries.end() || key < it->first) {
+    it = _entries.emplace(it, key, T());
+  }
+  return it->second;
+}
+
+template <typename K, typename T>
+bool FlatMap<K, T>::erase(const K& key) {
+  iterator it = lowerBound(key);
+  if (it == _entries.end() || key < it->first) {
+    return false;
+  }
+  _entries.erase(it);
+  return true;
+}
+
+template <typename K, typename T>
+void FlatMap<K, T>::clear() {
+  _entries.clear();
+}
+
+template <typename K, typename T>
+size_t FlatMap<K, T>::size() const {
+  return _entries.size();
+}
+
+template <typename K, typename T>
+bool FlatMap<K, T>::empty() const {
+  return _entries.empty();
+}
+
+template <typename K, typename T>
+typename FlatMap<K, T>::iterator FlatMap<K, T>::lowerBound(const K& key) {
+  return std::lower_bound(_entries.begin(), _entries.end(), key,
+                          [](const value_type& entry, const K& k) { return entry.first < k; });
+}
+
+template <typename K, typename T>
+typename FlatMap<K, T>::const_iterator FlatMap<K, T>::lowerBound(const K& key) const {
+  return std::lower_bound(_entries.begin(), _entries.end(), key,
+                          [](const value_type& entry, const K& k) { return entry.first < k; });
+}
+
+} // namespace vigilante
+
+#endif // VIGILANTE_FLAT_MAP_H_
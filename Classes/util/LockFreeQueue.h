@@ -0,0 +1,113 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_LOCK_FREE_QUEUE_H_
+#define VIGILANTE_LOCK_FREE_QUEUE_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace vigilante {
+
+// A bounded multi-producer multi-consumer queue (Dmitry Vyukov's design).
+//
+// Each slot carries a sequence number which tells whether it's ready to be
+// written (seq == pos) or read (seq == pos + 1), so producers and consumers
+// only contend on a single CAS of the enqueue/dequeue position.
+// tryPush() fails instead of blocking when the queue is full.
+//
+// Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class LockFreeQueue {
+ public:
+  LockFreeQueue();
+  virtual ~LockFreeQueue() = default;
+
+  // `fill` is called with the claimed slot, so that large values can be
+  // written in place instead of being copied in.
+  template <typename Fn>
+  bool tryPush(Fn fill);
+  // `consume` is called with the dequeued slot before it's handed back to the producers.
+  template <typename Fn>
+  bool tryPop(Fn consume);
+
+ private:
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+  struct Slot {
+    std::atomic<size_t> seq;
+    T data;
+  };
+
+  std::array<Slot, Capacity> _slots;
+  // Keep the producers' and the consumers' positions on separate cache lines.
+  std::atomic<size_t> _enqueuePos;
+  char _padding[64 - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> _dequeuePos;
+};
+
+
+
+template <typename T, size_t Capacity>
+LockFreeQueue<T, Capacity>::LockFreeQueue() : _slots(), _enqueuePos(0), _padding(), _dequeuePos(0) {
+  for (size_t i = 0; i < Capacity; i++) {
+    _slots[i].seq.store(i, std::memory_order_relaxed);
+  }
+}
+
+
+template <typename T, size_t Capacity>
+template <typename Fn>
+bool LockFreeQueue<T, Capacity>::tryPush(Fn fill) {
+  size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+  Slot* slot;
+
+  while (true) {
+    slot = &_slots[pos & (Capacity - 1)];
+    size_t seq = slot->seq.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false; // full
+    } else {
+      pos = _enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  fill(slot->data);
+  slot->seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T, size_t Capacity>
+template <typename Fn>
+bool LockFreeQueue<T, Capacity>::tryPop(Fn consume) {
+  size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+  Slot* slot;
+
+  while (true) {
+    slot = &_slots[pos & (Capacity - 1)];
+    size_t seq = slot->seq.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+    if (diff == 0) {
+      if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false; // empty
+    } else {
+      pos = _dequeuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  consume(slot->data);
+  slot->seq.store(pos + Capacity, std::memory_order_release);
+  return true;
+}
+
+} // namespace vigilante
+
+#endif // VIGILANTE_LOCK_FREE_QUEUE_H_
@@ -1,6 +1,18 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "Logger.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <condition_variable>
+
+#include "util/LockFreeQueue.h"
+
 extern "C" {
 #include <execinfo.h> // backtrace*
 #include <signal.h> // signal
@@ -12,15 +24,254 @@ extern "C" {
 #define NUM_STACKTRACE_FUNC 10
 #define LOG_FILENAME "vigilante.log"
 
+using std::mutex;
+using std::string;
+using std::unique_lock;
+
 namespace vigilante {
 
 namespace logger {
 
+namespace {
+
+const char* const _kSeverityStr[Severity::SIZE] = {
+  "ERROR",
+  "WARNING",
+  "INFO"
+};
+
+// LogWriter owns the queue of formatted messages and the flusher thread
+// which writes them to stdout and the log file.
+//
+// Producers only format their message into a queue slot, so VGLOG never
+// touches stdio or takes a lock on the calling thread. The flusher wakes up
+// every _kFlushInterval (or right away for errors and when the queue is full), drains the queue, and
+// rotates the log file once it grows past _kMaxLogFileSize:
+// vigilante.log -> vigilante.log.1 -> ... -> vigilante.log.<_kMaxBackupFiles>
+class LogWriter {
+ public:
+  static LogWriter* getInstance();
+  // Unlike getInstance(), this never creates the writer, so it's safe to call from
+  // a signal handler. Returns nullptr if nothing has been logged yet.
+  static LogWriter* getInstanceIfCreated();
+
+  void write(Severity severity, const char* fileName, int line, const char* format, va_list args);
+  void flush();
+  // Writes the queued records to `fd` with write(2), bypassing stdio and the flusher.
+  // Only meant for the SIGSEGV handler. See segvHandler().
+  void writePendingRecords(int fd);
+
+ private:
+  static constexpr size_t _kMaxRecordLength = 256; // longer messages are truncated
+  static constexpr size_t _kQueueCapacity = 1024;
+  static const long _kMaxLogFileSize;
+  static const int _kMaxBackupFiles;
+  static const std::chrono::milliseconds _kFlushInterval;
+
+  struct Record {
+    size_t length;
+    char text[_kMaxRecordLength];
+  };
+
+  static std::atomic<LogWriter*> _createdInstance;
+
+  LogWriter();
+  void runFlusher();
+  void drain();
+  void writeRecord(const char* text, size_t length);
+  void rotateLogFile();
+
+  LockFreeQueue<Record, _kQueueCapacity> _queue;
+  std::atomic<uint32_t> _numDroppedRecords;
+
+  std::thread _flusher;
+  mutex _mutex;
+  std::condition_variable _wakeCv;
+  std::condition_variable _idleCv;
+  uint64_t _flushRequestId;
+  uint64_t _flushedId;
+
+  // Only accessed by the flusher thread.
+  FILE* _logFile;
+  long _logFileSize;
+};
+
+const long LogWriter::_kMaxLogFileSize = 1024 * 1024;
+const int LogWriter::_kMaxBackupFiles = 3;
+const std::chrono::milliseconds LogWriter::_kFlushInterval(100);
+std::atomic<LogWriter*> LogWriter::_createdInstance(nullptr);
+
+LogWriter* LogWriter::getInstance() {
+  // VGLOG may be called from any thread, hence the function-local static.
+  // The writer is intentionally never destroyed, so that logging during
+  // static destruction still works. See logger::flush().
+  static LogWriter* instance = new LogWriter();
+  return instance;
+}
+
+LogWriter* LogWriter::getInstanceIfCreated() {
+  return _createdInstance.load(std::memory_order_acquire);
+}
+
+LogWriter::LogWriter()
+    : _queue(),
+      _numDroppedRecords(),
+      _flusher(),
+      _mutex(),
+      _wakeCv(),
+      _idleCv(),
+      _flushRequestId(),
+      _flushedId(),
+      _logFile(),
+      _logFileSize() {
+  rotateLogFile();
+  _flusher = std::thread(&LogWriter::runFlusher, this);
+  _createdInstance.store(this, std::memory_order_release);
+}
+
+
+void LogWriter::write(Severity severity, const char* fileName, int line, const char* format, va_list args) {
+  bool isPushed = _queue.tryPush([&](Record& record) {
+    // Leave room for the trailing newline.
+    size_t capacity = _kMaxRecordLength - 1;
+    int n = snprintf(record.text, capacity, "[%s] [%s: %d] ", _kSeverityStr[severity], fileName, line);
+    size_t length = (n < 0) ? 0 : (static_cast<size_t>(n) < capacity) ? n : capacity - 1;
+
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    n = vsnprintf(record.text + length, capacity - length, format, argsCopy);
+    va_end(argsCopy);
+    length += (n < 0) ? 0 : (static_cast<size_t>(n) < capacity - length) ? n : capacity - length - 1;
+
+    record.text[length++] = '\n';
+    record.length = length;
+  });
+
+  if (!isPushed) {
+    _numDroppedRecords.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (!isPushed || severity == Severity::ERROR) {
+    _wakeCv.notify_one();
+  }
+}
+
+void LogWriter::flush() {
+  unique_lock<mutex> lock(_mutex);
+  uint64_t requestId = ++_flushRequestId;
+  _wakeCv.notify_one();
+  _idleCv.wait(lock, [this, requestId]() { return _flushedId >= requestId; });
+}
+
+void LogWriter::writePendingRecords(int fd) {
+  // Popping a record only touches atomics and the slot itself,
+  // so unlike drain() this is async-signal-safe.
+  auto writeRecord = [fd](const Record& record) {
+    ssize_t n = ::write(fd, record.text, record.length);
+    (void) n; // nothing sensible to do about it while crashing
+  };
+  while (_queue.tryPop(writeRecord)) {}
+}
+
+
+void LogWriter::runFlusher() {
+  unique_lock<mutex> lock(_mutex);
+
+  while (true) {
+    if (_flushedId == _flushRequestId) {
+      _wakeCv.wait_for(lock, _kFlushInterval);
+    }
+
+    uint64_t requestId = _flushRequestId;
+    lock.unlock();
+    drain();
+    lock.lock();
+
+    _flushedId = requestId;
+    _idleCv.notify_all();
+  }
+}
+
+void LogWriter::drain() {
+  bool hasWritten = false;
+  while (true) {
+    while (_queue.tryPop([this](const Record& record) { writeRecord(record.text, record.length); })) {
+      hasWritten = true;
+    }
+
+    // Reported through the queue itself, which has room again by now.
+    uint32_t numDroppedRecords = _numDroppedRecords.exchange(0, std::memory_order_relaxed);
+    if (numDroppedRecords == 0) {
+      break;
+    }
+    VGLOG(LOG_WARN, "Log queue full, %u messages dropped", numDroppedRecords);
+  }
+
+  if (hasWritten) {
+    fflush(stdout);
+    if (_logFile) {
+      fflush(_logFile);
+    }
+  }
+}
+
+void LogWriter::writeRecord(const char* text, size_t length) {
+  fwrite(text, 1, length, stdout);
+
+  if (!_logFile) {
+    return;
+  }
+  fwrite(text, 1, length, _logFile);
+  _logFileSize += length;
+
+  if (_logFileSize >= _kMaxLogFileSize) {
+    fclose(_logFile);
+    rotateLogFile();
+  }
+}
+
+void LogWriter::rotateLogFile() {
+  // Each session starts with a fresh log file as well.
+  string logFileName = LOG_FILENAME;
+  std::remove((logFileName + "." + std::to_string(_kMaxBackupFiles)).c_str());
+  for (int i = _kMaxBackupFiles - 1; i >= 1; i--) {
+    std::rename((logFileName + "." + std::to_string(i)).c_str(),
+                (logFileName + "." + std::to_string(i + 1)).c_str());
+  }
+  std::rename(logFileName.c_str(), (logFileName + ".1").c_str());
+
+  _logFile = fopen(LOG_FILENAME, "a");
+  _logFileSize = 0;
+}
+
+} // namespace
+
+
+void write(Severity severity, const char* fileName, int line, const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  LogWriter::getInstance()->write(severity, fileName, line, format, args);
+  va_end(args);
+}
+
+void flush() {
+  LogWriter::getInstance()->flush();
+}
+
+
 void segvHandler(int) {
   void* array[10];
   size_t size = backtrace(array, 10);
 
-  int fd = open(LOG_FILENAME, O_CREAT | O_WRONLY, 0600);
+  // Append the backtrace to this session's log.
+  int fd = open(LOG_FILENAME, O_CREAT | O_WRONLY | O_APPEND, 0600);
+
+  // The messages logged right before the crash are usually still queued, since the
+  // flusher only wakes up every 100 ms. Write them first, on a best-effort basis:
+  // the ones the flusher has already popped but not yet fflush()ed are still lost,
+  // and if the flusher is draining right now, the two may interleave.
+  if (LogWriter* writer = LogWriter::getInstanceIfCreated()) {
+    writer->writePendingRecords(fd);
+  }
   backtrace_symbols_fd(array + 2, size - 2, fd);
   close(fd);
 
@@ -2,10 +2,6 @@
 #ifndef VIGILANTE_LOGGER_H_
 #define VIGILANTE_LOGGER_H_
 
-#include <array>
-#include <string>
-#include <memory>
-
 #include <cocos2d.h>
 
 // Log severity
@@ -13,13 +9,32 @@
 #define LOG_WARN vigilante::logger::Severity::WARNING
 #define LOG_INFO vigilante::logger::Severity::INFO
 
-// Example usage: VGLOG(LOG_INFO, __FILE__, "test msg %d", 5);
+// Messages less severe than this are compiled out,
+// e.g. -DVIGILANTE_LOG_LEVEL=LOG_WARN
+#ifndef VIGILANTE_LOG_LEVEL
+#define VIGILANTE_LOG_LEVEL LOG_INFO
+#endif
+
+// Lets the compiler check VGLOG's arguments against its format string.
+// MSVC has no equivalent attribute.
+#if defined(__GNUC__) || defined(__clang__)
+#define VIGILANTE_PRINTF_FORMAT(formatIndex, firstArgIndex)\
+  __attribute__((format(printf, formatIndex, firstArgIndex)))
+#else
+#define VIGILANTE_PRINTF_FORMAT(formatIndex, firstArgIndex)
+#endif
+
+// Example usage: VGLOG(LOG_INFO, "test msg %d", 5);
+//
+// The message is formatted on the calling thread and queued,
+// and then written to stdout and the log file by a background thread.
 #define VGLOG(severity, format, ...)\
-  cocos2d::log("[%s] [%s: %d] " format,\
-      (vigilante::logger::_kSeverityStr[severity].c_str()),\
-      (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__),\
-      (__LINE__),\
-      ##__VA_ARGS__)
+  do {\
+    if ((severity) <= VIGILANTE_LOG_LEVEL) {\
+      static constexpr const char* _kVglogFileName = vigilante::logger::getFileName(__FILE__);\
+      vigilante::logger::write((severity), _kVglogFileName, (__LINE__), format, ##__VA_ARGS__);\
+    }\
+  } while (0)
 
 
 namespace vigilante {
@@ -32,11 +47,24 @@ enum Severity {
   INFO,
   SIZE
 };
-const std::array<std::string, Severity::SIZE> _kSeverityStr = {{
-  "ERROR",
-  "WARNING",
-  "INFO"
-}};
+
+// Returns the part of `path` after the last path separator.
+// Evaluated at compile time by VGLOG.
+constexpr const char* getFileName(const char* path, const char* fileName) {
+  return (*path == '\0') ? fileName
+    : getFileName(path + 1, (*path == '/' || *path == '\\') ? path + 1 : fileName);
+}
+
+constexpr const char* getFileName(const char* path) {
+  return getFileName(path, path);
+}
+
+// Never blocks. If the queue is full, the message is dropped
+// and the number of dropped messages is logged later on.
+void write(Severity severity, const char* fileName, int line, const char* format, ...)
+  VIGILANTE_PRINTF_FORMAT(4, 5);
+// Blocks until all queued messages have been written to the log file.
+void flush();
 
 
 // SIGSEGV handler
@@ -0,0 +1,52 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "Profiler.h"
+
+#include "util/Logger.h"
+
+using std::chrono::duration;
+using std::chrono::duration_cast;
+
+namespace vigilante {
+
+Profiler::Scope::Scope(Profiler& profiler, const char* section)
+    : _profiler(profiler), _section(section), _begin(Clock::now()) {}
+
+Profiler::Scope::~Scope() {
+  _profiler.add(_section, Clock::now() - _begin);
+}
+
+
+Profiler::Profiler() : _sections() {}
+
+void Profiler::add(const char* section, Clock::duration d) {
+  for (auto& s : _sections) {
+    if (s.first == section) {
+      s.second += d;
+      return;
+    }
+  }
+  _sections.push_back({section, d});
+}
+
+void Profiler::reset() {
+  _sections.clear();
+}
+
+void Profiler::report(uint64_t numTicks) const {
+  if (numTicks == 0) {
+    return;
+  }
+
+  Clock::duration total = Clock::duration::zero();
+  for (const auto& s : _sections) {
+    total += s.second;
+  }
+
+  for (const auto& s : _sections) {
+    double ms = duration_cast<duration<double, std::milli>>(s.second).count() / numTicks;
+    double percentage = (total.count() > 0) ? 100.0 * s.second.count() / total.count() : 0;
+    VGLOG(LOG_INFO, "%-10s %8.4f ms/tick (%5.1f%%)", s.first.c_str(), ms, percentage);
+  }
+}
+
+} // namespace vigilante
@@ -0,0 +1,50 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_PROFILER_H_
+#define VIGILANTE_PROFILER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace vigilante {
+
+// Accumulates the time spent in named sections of the game loop.
+// Usage:
+//   {
+//     Profiler::Scope scope(profiler, "physics");
+//     world->Step(...);
+//   }
+class Profiler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  class Scope {
+   public:
+    Scope(Profiler& profiler, const char* section);
+    ~Scope();
+
+   private:
+    Profiler& _profiler;
+    const char* _section;
+    Clock::time_point _begin;
+  };
+
+  Profiler();
+  virtual ~Profiler() = default;
+
+  void add(const char* section, Clock::duration duration);
+  void reset();
+
+  // Logs the average time per tick of each section.
+  void report(uint64_t numTicks) const;
+
+ private:
+  // Sections are kept in the order they are first seen.
+  std::vector<std::pair<std::string, Clock::duration>> _sections;
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_PROFILER_H_
@@ -1,23 +1,51 @@
 // Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
 #include "RandUtil.h"
 
+#include <array>
 #include <ctime>
-#include <random>
+
+using std::array;
+using vigilante::Rng;
+using vigilante::rand_util::Stream;
+
+namespace {
+
+unsigned int seed = 0;
+array<Rng, Stream::STREAM_SIZE> streams;
+
+} // namespace
+
 
 namespace vigilante {
 
 namespace rand_util {
 
 void init() {
-  srand(time(nullptr));
+  init(time(nullptr));
+}
+
+void init(unsigned int seed) {
+  ::seed = seed;
+  for (size_t i = 0; i < ::streams.size(); i++) {
+    ::streams[i].seed(seed, i);
+  }
+}
+
+unsigned int getSeed() {
+  return ::seed;
 }
 
-int randInt(int min, int max) {
-  return (rand() % (max + 1 - min)) + min;
+Rng& getStream(Stream stream) {
+  return ::streams[stream];
+}
+
+
+int randInt(int min, int max, Stream stream) {
+  return ::streams[stream].randInt(min, max);
 }
 
-float randFloat(float min, float max) {
-  return (float(rand()) / (float(RAND_MAX) + 1.0)) * (max - min) + min;
+float randFloat(float min, float max, Stream stream) {
+  return ::streams[stream].randFloat(min, max);
 }
 
 } // namespace rand_util
@@ -2,13 +2,33 @@
 #ifndef VIGILANTE_RAND_UTIL_H_
 #define VIGILANTE_RAND_UTIL_H_
 
+#include "util/Rng.h"
+
 namespace vigilante {
 
 namespace rand_util {
 
+// Each subsystem draws from its own stream, so e.g. a camera shake
+// never changes which items an enemy drops.
+// All streams are only meant to be used from the main thread.
+enum Stream {
+  GAMEPLAY, // damage, combat
+  LOOT,     // item drops
+  AI,       // seeds the per-bot generators (see Bot.h)
+  COSMETIC, // camera shake, animation variations
+  STREAM_SIZE
+};
+
+// Seeds every stream with the current time.
 void init();
-int randInt(int min=0, int max=1);
-float randFloat(float min=0.0f, float max=1.0f);
+// Seeds every stream with the given seed (e.g., that of a replay).
+void init(unsigned int seed);
+unsigned int getSeed();
+
+Rng& getStream(rand_util::Stream stream);
+
+int randInt(int min=0, int max=1, rand_util::Stream stream=Stream::GAMEPLAY);
+float randFloat(float min=0.0f, float max=1.0f, rand_util::Stream stream=Stream::GAMEPLAY);
 
 } // namespace rand_util
 
@@ -0,0 +1,67 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "Rng.h"
+
+namespace vigilante {
+
+Rng::Rng(uint64_t seed, uint64_t stream) : _state(), _inc() {
+  this->seed(seed, stream);
+}
+
+
+void Rng::seed(uint64_t seed, uint64_t stream) {
+  _state = 0;
+  _inc = (stream << 1u) | 1u;
+  next();
+  _state += seed;
+  next();
+}
+
+uint32_t Rng::next() {
+  uint64_t oldState = _state;
+  _state = oldState * 6364136223846793005ULL + _inc;
+  uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+  uint32_t rot = static_cast<uint32_t>(oldState >> 59u);
+  return (xorShifted >> rot) | (xorShifted << ((-rot) & 31));
+}
+
+uint32_t Rng::nextBounded(uint32_t bound) {
+  // Lemire's nearly divisionless method: the high 32 bits of next() * bound
+  // are uniform in [0, bound) once the few biased low values are rejected.
+  uint64_t m = static_cast<uint64_t>(next()) * bound;
+  uint32_t low = static_cast<uint32_t>(m);
+  if (low < bound) {
+    uint32_t threshold = -bound % bound;
+    while (low < threshold) {
+      m = static_cast<uint64_t>(next()) * bound;
+      low = static_cast<uint32_t>(m);
+    }
+  }
+  return static_cast<uint32_t>(m >> 32);
+}
+
+
+int Rng::randInt(int min, int max) {
+  uint32_t range = static_cast<uint32_t>(max) - static_cast<uint32_t>(min) + 1;
+  uint32_t offset = (range == 0) ? next() : nextBounded(range); // range == 0 means the full 32-bit range
+  return static_cast<int>(static_cast<uint32_t>(min) + offset);
+}
+
+float Rng::randFloat(float min, float max) {
+  // The upper 24 bits fill a float's mantissa exactly.
+  float f = (next() >> 8) * (1.0f / 16777216.0f);
+  return f * (max - min) + min;
+}
+
+void Rng::randInts(int min, int max, int* out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = randInt(min, max);
+  }
+}
+
+void Rng::randFloats(float min, float max, float* out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = randFloat(min, max);
+  }
+}
+
+} // namespace vigilante
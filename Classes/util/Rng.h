@@ -0,0 +1,43 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_RNG_H_
+#define VIGILANTE_RNG_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vigilante {
+
+// A PCG32 (XSH-RR) pseudo random number generator.
+// See: https://www.pcg-random.org/
+//
+// Generators with the same seed but different streams produce independent
+// sequences. Bounded sampling is unbiased (Lemire's method), unlike rand() % n.
+// An Rng is not thread-safe, give each thread its own.
+class Rng {
+ public:
+  explicit Rng(uint64_t seed=0, uint64_t stream=0);
+  virtual ~Rng() = default;
+
+  void seed(uint64_t seed, uint64_t stream=0);
+
+  uint32_t next();
+  // Returns a value in [0, bound).
+  uint32_t nextBounded(uint32_t bound);
+
+  // Returns a value in [min, max].
+  int randInt(int min=0, int max=1);
+  // Returns a value in [min, max).
+  float randFloat(float min=0.0f, float max=1.0f);
+
+  // Batch versions of the above, for bursts (e.g. loot rolls, particles).
+  void randInts(int min, int max, int* out, size_t n);
+  void randFloats(float min, float max, float* out, size_t n);
+
+ private:
+  uint64_t _state;
+  uint64_t _inc; // must be odd
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_RNG_H_
@@ -0,0 +1,104 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#include "ThreadPool.h"
+
+using std::mutex;
+using std::thread;
+using std::function;
+using std::unique_lock;
+using std::lock_guard;
+
+namespace vigilante {
+
+const size_t ThreadPool::_kMinParallelTasks = 16;
+
+ThreadPool::ThreadPool(size_t numWorkers)
+    : _workers(),
+      _mutex(),
+      _taskCv(),
+      _doneCv(),
+      _func(),
+      _numTasks(),
+      _nextTask(),
+      _numBusyWorkers(),
+      _generation(),
+      _isShuttingDown() {
+  for (size_t i = 0; i < numWorkers; i++) {
+    _workers.push_back(thread(&ThreadPool::runWorker, this));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    lock_guard<mutex> lock(_mutex);
+    _isShuttingDown = true;
+  }
+  _taskCv.notify_all();
+
+  for (auto& worker : _workers) {
+    worker.join();
+  }
+}
+
+
+void ThreadPool::parallelFor(size_t n, const function<void (size_t)>& func) {
+  if (_workers.empty() || n < _kMinParallelTasks) {
+    for (size_t i = 0; i < n; i++) {
+      func(i);
+    }
+    return;
+  }
+
+  {
+    lock_guard<mutex> lock(_mutex);
+    _func = &func;
+    _numTasks = n;
+    _nextTask = 0;
+    _numBusyWorkers = _workers.size();
+    _generation++;
+  }
+  _taskCv.notify_all();
+
+  // The calling thread works on the tasks too.
+  runTasks();
+
+  unique_lock<mutex> lock(_mutex);
+  _doneCv.wait(lock, [this]() { return _numBusyWorkers == 0; });
+  _func = nullptr;
+}
+
+size_t ThreadPool::getNumWorkers() const {
+  return _workers.size();
+}
+
+
+void ThreadPool::runWorker() {
+  unsigned int lastGeneration = 0;
+
+  while (true) {
+    {
+      unique_lock<mutex> lock(_mutex);
+      _taskCv.wait(lock, [&]() { return _isShuttingDown || _generation != lastGeneration; });
+      if (_isShuttingDown) {
+        return;
+      }
+      lastGeneration = _generation;
+    }
+
+    runTasks();
+
+    {
+      lock_guard<mutex> lock(_mutex);
+      if (--_numBusyWorkers == 0) {
+        _doneCv.notify_one();
+      }
+    }
+  }
+}
+
+void ThreadPool::runTasks() {
+  for (size_t i = _nextTask++; i < _numTasks; i = _nextTask++) {
+    (*_func)(i);
+  }
+}
+
+} // namespace vigilante
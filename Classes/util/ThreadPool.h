@@ -0,0 +1,51 @@
+// Copyright (c) 2019 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+#ifndef VIGILANTE_THREAD_POOL_H_
+#define VIGILANTE_THREAD_POOL_H_
+
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <functional>
+
+namespace vigilante {
+
+// A fixed-size pool of worker threads for data-parallel loops.
+// The workers are created once and sleep between parallelFor() calls.
+class ThreadPool {
+ public:
+  // By default, one worker per hardware thread except the calling (main) thread.
+  explicit ThreadPool(size_t numWorkers=std::max(std::thread::hardware_concurrency(), 1u) - 1);
+  virtual ~ThreadPool();
+
+  // Calls func(i) for every i in [0, n) on the workers and the calling thread,
+  // and blocks until all of them have returned. func must be thread-safe.
+  void parallelFor(size_t n, const std::function<void (size_t)>& func);
+
+  size_t getNumWorkers() const;
+
+ private:
+  void runWorker();
+  void runTasks();
+
+  // Below this many tasks, parallelFor() simply runs on the calling thread.
+  static const size_t _kMinParallelTasks;
+
+  std::vector<std::thread> _workers;
+  std::mutex _mutex;
+  std::condition_variable _taskCv;
+  std::condition_variable _doneCv;
+
+  const std::function<void (size_t)>* _func;
+  size_t _numTasks;
+  std::atomic<size_t> _nextTask;
+  size_t _numBusyWorkers;
+  unsigned int _generation;
+  bool _isShuttingDown;
+};
+
+} // namespace vigilante
+
+#endif // VIGILANTE_THREAD_POOL_H_
@@ -4,6 +4,7 @@
 #include <stdexcept>
 
 #include "../Classes/AppDelegate.h"
+#include "../Classes/input/InputRecorder.h"
 #include "../Classes/util/Logger.h"
 
 int main(int argc, char* args[]) {
@@ -14,6 +15,35 @@ int main(int argc, char* args[]) {
   AppDelegate app;
 
   try {
+    // Command line options:
+    // --record <file>: record the keyboard input of this session to <file>.
+    // --replay <file>: replay a recorded session.
+    // --bench: replay as fast as possible and report ticks/sec and timings.
+    std::string recordFileName;
+    std::string replayFileName;
+    bool isBenchmarkMode = false;
+
+    for (int i = 1; i < argc; i++) {
+      std::string arg = args[i];
+      if (arg == "--record" && i + 1 < argc) {
+        recordFileName = args[++i];
+      } else if (arg == "--replay" && i + 1 < argc) {
+        replayFileName = args[++i];
+      } else if (arg == "--bench") {
+        isBenchmarkMode = true;
+      } else {
+        std::cerr << "Unknown option: " << arg << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    vigilante::InputRecorder* recorder = vigilante::InputRecorder::getInstance();
+    if (!replayFileName.empty()) {
+      recorder->loadReplay(replayFileName, isBenchmarkMode);
+    } else if (!recordFileName.empty()) {
+      recorder->requestRecording(recordFileName);
+    }
+
     return cocos2d::Application::getInstance()->run();
   } catch (const std::exception& ex) {
     std::cerr << ex.what() << std::endl;